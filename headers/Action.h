@@ -1,7 +1,9 @@
 #pragma once
 #include <boost/shared_ptr.hpp>
+#include <ostream>
 #include <string>
 #include <vector>
+#include "Process.h"
 #include "PH.h"
 #include "GAction.h"
 
@@ -13,8 +15,7 @@
   */
 
 
-class Action;
-typedef boost::shared_ptr<Action> ActionPtr;
+class PH;
 
 class GAction;
 typedef boost::shared_ptr<GAction> GActionPtr;
@@ -23,6 +24,7 @@ typedef boost::shared_ptr<GAction> GActionPtr;
 /**
   * @class Action
   * @brief Represents an Action of the process hitting
+  * @details light handle on a row of the ActionTable of its PH, to be passed by value
   *
   */
 class Action {
@@ -31,18 +33,16 @@ class Action {
     /**
       * @brief constructor
       *
-      * @param ProcessPtr the source Process of the hit
-      * @param ProcessPtr the target Process of the hit
-      * @param ProcessPtr the result of the hit
-      * @param bool determines whether the rate of the hit is infinite or not
-      * @param double the rate of the hit
-      * @param int the stochasticity absorption of the hit
+      * @param PH* the process hitting the action belongs to
+      * @param int the index of the action in the ActionTable of the PH
       */
-		Action 	(	ProcessPtr source_, ProcessPtr target_, ProcessPtr result_
-				, 	const bool& infiniteRate_
-				, 	const double& r_
-				,	const int& sa_
-				);
+		Action 	(PH* ph_, int index_);
+
+        /**
+          * @brief gets the index of the action in the ActionTable of its PH
+          *
+          */
+        int getIndex();
 
         /**
           * @brief gets the source Process
@@ -66,55 +66,61 @@ class Action {
 		ProcessPtr getResult();
 
         /**
-          * @brief gives a text representation of the Process (as it would be in a .ph file)
+          * @brief determines whether the rate of the hit is infinite or not
           *
-          * @return string the text representation of the Process
           */
-		string toString (void);
+        bool getInfiniteRate();
 
         /**
-          * @brief gives a text representation of the Process (in .dot format, used in Graphviz)
+          * @brief gets the rate of the hit
           *
-          * @return string the text representation of the Process
           */
-		string toDotString (void);
-
-	protected:
-
-       /**
-         * @brief the source Process
-         *
-         */
-        ProcessPtr source;
+        float getRate();
 
         /**
-          * @brief the target Process
+          * @brief gets the stochasticity absorption
           *
           */
-		ProcessPtr target;
+        int getStochasticityAbsorption();
 
         /**
-          * @brief the result Process
+          * @brief gives a text representation of the Process (as it would be in a .ph file)
           *
+          * @return string the text representation of the Process
           */
-        ProcessPtr result;
+		string toString (void);
 
         /**
-          * @brief Boolean that determines whether the rate of the hit is infinite or not
+          * @brief gives a text representation of the Process (in .dot format, used in Graphviz)
           *
+          * @return string the text representation of the Process
           */
-        bool infiniteRate;
+		string toDotString (void);
 
         /**
-          * @brief the rate of the hit
-          *
+          * @brief writes the Action as it would be in a .ph file, without temporary strings
+          * @param ostream the stream to write to
+          */
+		void write (std::ostream& out);
+
+        /**
+          * @brief writes the two edges of the Action in DOT format
+          * @param ostream the stream to write to
           */
-        float r;
+		void writeDot (std::ostream& out);
+
+	protected:
+
+       /**
+         * @brief the process hitting the action belongs to
+         *
+         */
+        PH* ph;
 
         /**
-          * @brief the stochasticity absorption
+          * @brief the index of the action in the ActionTable of the PH
           *
           */
-        int sa;
+        int index;
 		
 };
@@ -0,0 +1,167 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+/**
+  * @file ActionTable.h
+  * @brief header for the ActionTable class
+  * @author PGROU_2013
+  *
+  */
+
+using std::vector;
+
+
+/**
+  * @class ActionTable
+  * @brief stores the actions of a process hitting column by column
+  * @details the i-th action is made of the i-th element of each column, processes are given
+  * by their identifiers in the PH: full scans only read the columns they need
+  *
+  */
+class ActionTable {
+
+	public:
+
+        /**
+          * @brief adds an action at the end of the table
+          * @param int identifier of the source Process
+          * @param int identifier of the target Process
+          * @param int identifier of the result Process
+          * @param bool determines whether the rate of the hit is infinite or not
+          * @param float the rate of the hit
+          * @param int the stochasticity absorption of the hit
+          * @return int the index of the action
+          *
+          */
+        int add (int source, int target, int result, bool infiniteRate, float rate, int sa);
+
+        /**
+          * @brief reserves room for the given number of actions
+          *
+          */
+        void reserve (int n);
+
+        /**
+          * @brief replaces the content of the table by the given columns
+          * @details used to load whole tables at once, e.g. from a compiled model
+          * @param int the number of actions, i.e. the length of each column
+          *
+          */
+        void assign (int n, const int32_t* sources, const int32_t* targets, const int32_t* results,
+                     const uint8_t* infiniteRates, const float* rates, const int32_t* sa);
+
+        /**
+          * @brief number of actions
+          *
+          */
+        int size (void) const;
+
+        /**
+          * @brief columns, read only
+          *
+          */
+        const vector<int32_t>& getSources (void) const;
+        const vector<int32_t>& getTargets (void) const;
+        const vector<int32_t>& getResults (void) const;
+        const vector<uint8_t>& getInfiniteRates (void) const;
+        const vector<float>& getRates (void) const;
+        const vector<int32_t>& getStochasticityAbsorptions (void) const;
+
+	protected:
+
+        /**
+          * @brief identifiers of the source, target and result Processes
+          *
+          */
+        vector<int32_t> sources;
+        vector<int32_t> targets;
+        vector<int32_t> results;
+
+        /**
+          * @brief whether the rate of the hit is infinite, 0 or 1
+          *
+          */
+        vector<uint8_t> infiniteRates;
+
+        /**
+          * @brief rates of the hits
+          *
+          */
+        vector<float> rates;
+
+        /**
+          * @brief stochasticity absorptions of the hits
+          *
+          */
+        vector<int32_t> stochasticityAbsorptions;
+};
+
+
+/**
+  * @class ActionRange
+  * @brief read only range of action indexes, usable in range-based for loops
+  *
+  */
+class ActionRange {
+
+	public:
+        ActionRange (const int32_t* first_, const int32_t* last_) : first(first_), last(last_) {}
+        const int32_t* begin (void) const { return first; }
+        const int32_t* end (void) const { return last; }
+        int size (void) const { return last - first; }
+
+	protected:
+        const int32_t* first;
+        const int32_t* last;
+};
+
+
+/**
+  * @class ActionIndex
+  * @brief compressed (CSR) index from keys (processes, sorts) to the actions related to them
+  * @details the actions of key k are actions[offsets[k]] to actions[offsets[k + 1] - 1],
+  * in increasing order
+  *
+  */
+class ActionIndex {
+
+	public:
+
+        /**
+          * @brief builds the index from one column of keys
+          * @param vector<int32_t> the key of each action, -1 if the action has none
+          * @param int the number of keys
+          *
+          */
+        void build (const vector<int32_t>& keys, int keyCount);
+
+        /**
+          * @brief builds the index from two columns of keys, an action is listed once per distinct key
+          * @param vector<int32_t> the first key of each action
+          * @param vector<int32_t> the second key of each action
+          * @param int the number of keys
+          *
+          */
+        void build (const vector<int32_t>& keys, const vector<int32_t>& otherKeys, int keyCount);
+
+        /**
+          * @brief the actions related to the key
+          *
+          */
+        ActionRange get (int key) const;
+
+	protected:
+
+        /**
+          * @brief where the actions of each key start, keyCount + 1 elements
+          *
+          */
+        vector<int32_t> offsets;
+
+        /**
+          * @brief the action indexes, grouped by key
+          *
+          */
+        vector<int32_t> actions;
+};
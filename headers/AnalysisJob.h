@@ -0,0 +1,211 @@
+#pragma once
+#include <functional>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QObject>
+#include <QProcess>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+/**
+  * @file AnalysisJob.h
+  * @brief header for the AnalysisJob class
+  * @author PGROU_2013
+  *
+  */
+
+
+/**
+  * @class AnalysisJob
+  * @brief a run of an analysis (a program such as ph-stable or ph-exec, or a task of the program), which
+  * does not block the GUI thread
+  * @details programs are driven by the signals of QProcess: their standard output and error are handed over
+  * as soon as they are written. Tasks run in a worker thread, and write their output with write().
+  * A job may be cancelled at any time, and several jobs may run at once
+  *
+  */
+class AnalysisJob : public QObject {
+
+    Q_OBJECT
+
+	public:
+
+        /**
+          * @brief states of a job, in order
+          *
+          */
+        enum State { Starting, Running, Finished, Failed, Cancelled };
+
+        /**
+          * @brief constructor, the program is not started yet
+          * @param QString the program to run
+          * @param QStringList its arguments
+          * @param QString the model analysed (a path, or the name of its tab), to be displayed
+          *
+          */
+        AnalysisJob (const QString& program, const QStringList& arguments, const QString& model, QObject* parent = 0);
+
+        /**
+          * @brief a task run by a worker thread, which returns its exit code (0 if it succeeded)
+          * @details it should call isCancelRequested() often, and stop when it returns true
+          *
+          */
+        typedef std::function<int (AnalysisJob&)> Task;
+
+        /**
+          * @brief constructor of a job running a task of the program, which is not started yet
+          * @param QString the name of the task, to be displayed
+          * @param Task the task
+          * @param QString the model analysed, to be displayed
+          *
+          */
+        AnalysisJob (const QString& name, Task task, const QString& model, QObject* parent = 0);
+
+        /**
+          * @brief destructor, kills the process if it is still running, or waits for the task to stop
+          *
+          */
+        ~AnalysisJob ();
+
+        /**
+          * @brief starts the program or the task, the job fails if the program cannot be found
+          *
+          */
+        void start (void);
+
+        /**
+          * @brief called in the GUI thread once the job is over, e.g. to show the result of a task
+          *
+          */
+        typedef std::function<void (AnalysisJob&)> Callback;
+        void setCallback (Callback c);
+
+        /**
+          * @brief adds to the output of a task, may be called from any thread
+          * @param QString the text to add
+          * @param bool whether it is an error message
+          *
+          */
+        void write (const QString& text, bool error = false);
+
+        /**
+          * @brief whether the task should stop, may be called from any thread
+          *
+          */
+        bool isCancelRequested (void);
+
+        QString getProgram (void);
+        QStringList getArguments (void);
+        QString getModel (void);
+        State getState (void);
+
+        /**
+          * @brief everything the program wrote so far, standard output and error mixed in order
+          *
+          */
+        QString getOutput (void);
+
+        /**
+          * @brief exit code of the program, once finished
+          *
+          */
+        int getExitCode (void);
+
+        /**
+          * @brief time elapsed since the program was started, or that it ran once done, in milliseconds
+          *
+          */
+        qint64 getElapsed (void);
+
+        /**
+          * @brief whether the program is still running (or starting)
+          *
+          */
+        bool isRunning (void);
+
+        /**
+          * @brief name of a state, to be displayed
+          *
+          */
+        static QString stateName (State state);
+
+	public slots:
+
+        /**
+          * @brief asks the program to stop, then kills it if it is still running after a while
+          *
+          */
+        void cancel (void);
+
+    signals:
+
+        /**
+          * @brief emitted when the program wrote something
+          * @param QString what it wrote
+          * @param bool whether it was written to the standard error
+          *
+          */
+        void output (QString text, bool error);
+
+        /**
+          * @brief emitted by the worker thread once the task is done
+          *
+          */
+        void taskFinished (int exitCode);
+
+        /**
+          * @brief emitted when the state changed
+          *
+          */
+        void stateChanged (void);
+
+	private slots:
+
+        void started (void);
+        void readOutput (void);
+        void readError (void);
+        void finished (int exitCode, QProcess::ExitStatus exitStatus);
+        void error (QProcess::ProcessError error);
+
+        /**
+          * @brief called when the program did not stop after cancel()
+          *
+          */
+        void kill (void);
+
+        /**
+          * @brief called in the GUI thread when the task is done
+          *
+          */
+        void taskDone (int exitCode);
+
+	private:
+
+        void setState (State s);
+
+        friend class AnalysisJobTask;
+
+        QProcess process;
+        QString program;
+        QStringList arguments;
+        QString model;
+        State state;
+        QString text;
+        QMutex textMutex;
+        int exitCode;
+        qint64 startTime;
+        qint64 elapsed;
+        QTimer killTimer;
+
+        /**
+          * @brief the task, if the job does not run a program, and whether its worker thread is running
+          *
+          */
+        Task task;
+        Callback callback;
+        bool working;
+        QAtomicInt cancelRequested;
+        QSemaphore stopped;
+};
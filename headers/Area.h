@@ -6,6 +6,10 @@
 #include "TreeArea.h"
 #include "MainWindow.h"
 #include "ColorerSequences.h"
+#include "PHReplay.h"
+
+class QLabel;
+class QSlider;
 
 
 /**
@@ -42,6 +46,37 @@ public:
       */
     MyArea *myArea;
 
+    /**
+      * @brief bar under the scene to move through a path replayed in it: buttons, slider and action played
+      *
+      */
+    QWidget *replayBar;
+    QSlider *replaySlider;
+    QLabel *replayLabel;
+    QPushButton *replayPlayButton;
+    QTimer *replayTimer;
+
+    /**
+      * @brief the path replayed in the scene, if any
+      *
+      */
+    PHReplayPtr replay;
+
+    /**
+      * @brief replays a path of the model in the scene, step by step
+      * @param vector the indexes of the actions played, from the initial state
+      *
+      */
+    void startReplay(const vector<int>& actions);
+
+    /**
+      * @brief highlights a global state of the model in the scene (e.g. a fixpoint), in place of any replay
+      * @param vector the number of the process of each sort
+      * @param QString what the state is, shown in the replay bar
+      *
+      */
+    void showState(const vector<int>& processes, const QString& title);
+
     /**
       * @brief pointer to the indicatorEdit
       *
@@ -54,6 +89,12 @@ public:
       */
     TextArea *textArea;
 
+    /**
+      * @brief parses the text in the background while it is edited, to underline the errors
+      *
+      */
+    ModelValidator *validator;
+
     /**
       * @brief pointer to the treeArea;
       *
@@ -218,9 +259,11 @@ public slots:
 
     /**
       * @brief method to save text change clicking on the button
+      * @details the model is parsed again, but only the sorts and actions which changed are redrawn
+      * (see PHDiff), so that the others keep their position and style
       *
       */
-    void saveEdit(int del = 0);
+    void saveEdit();
 
     /**
       * @brief method call by the signal textChanged()
@@ -228,6 +271,43 @@ public slots:
       */
     void onTextEdit();
 
+    /**
+      * @brief method call by the signal textChanged(), to validate the new text in the background
+      *
+      */
+    void validateText();
+
+    /**
+      * @brief method call by the validator once it is done, to underline the errors in the text area
+      *
+      */
+    void showDiagnostics();
+
+    /**
+      * @brief shows a step of the path replayed, called by the slider
+      *
+      */
+    void replayStep(int step);
+
+    /**
+      * @brief moves to the next or the previous step of the path replayed
+      *
+      */
+    void replayNext();
+    void replayPrevious();
+
+    /**
+      * @brief plays the path replayed, one step a second, or pauses it
+      *
+      */
+    void replayPlayOrPause();
+
+    /**
+      * @brief ends the replay, the scene gets back its style
+      *
+      */
+    void stopReplay();
+
     /**
       * @brief method to save all the new textArea into the QStringList
       *
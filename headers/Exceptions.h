@@ -56,6 +56,8 @@ struct wrong_import_file: virtual io_error { };
 
 //Parse errors
 typedef error_info<struct parse_detail, string> parse_info;
+typedef error_info<struct parse_line, int> line_info;
+typedef error_info<struct parse_column, int> column_info;
 
 /**
   * @class ph_parse_error
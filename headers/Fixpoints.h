@@ -0,0 +1,136 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <stdint.h>
+#include <QtGlobal>
+#include "PH.h"
+
+/**
+  * @file Fixpoints.h
+  * @brief header for the Fixpoints class
+  * @author PGROU_2013
+  *
+  */
+
+using std::vector;
+
+
+/**
+  * @class Fixpoints
+  * @brief enumerates the fixpoints of a process hitting: global states in which no action can be played
+  * @details a fixpoint gives one process per sort such that no action has both its hitter and its target active.
+  * Each action thus forbids a pair of processes (or a process alone, when it hits itself), and the fixpoints
+  * are the solutions of that constraint problem. They are searched depth first: the sort with the fewest
+  * processes left is chosen, and choosing a process removes the processes it is forbidden with, a sort
+  * left with one process being chosen in turn, a branch ending as soon as a sort has none left.
+  * The first levels of the search are split in subproblems taken in turn by several threads.
+  * The model is copied by the constructor, so that the search may run in the background while the PH is edited
+  *
+  */
+class Fixpoints {
+
+	public:
+
+        /**
+          * @brief a global state: the number of the active process of each sort, by sort identifier
+          *
+          */
+        typedef vector<int> State;
+
+        /**
+          * @brief limits of the search
+          *
+          */
+        struct Options {
+            int             threads;        //!< 0 for as many as cores
+            size_t          maxFixpoints;   //!< the search stops once that many fixpoints are found
+            Options (void);
+        };
+
+        /**
+          * @brief what the search found
+          *
+          */
+        struct Result {
+            size_t  fixpoints;  //!< number of fixpoints found
+            size_t  nodes;      //!< number of choices of a process made
+            bool    complete;   //!< false if cancelled or stopped by maxFixpoints
+            qint64  elapsed;    //!< in milliseconds
+            Result (void);
+        };
+
+        /**
+          * @brief called with the fixpoints as they are found, by batches, from the threads of the search
+          * @details the calls are serialized
+          *
+          */
+        typedef std::function<void (const vector<State>&)> Found;
+
+        /**
+          * @brief copies the sorts and actions of a process hitting
+          *
+          */
+        Fixpoints (PH& ph);
+
+        /**
+          * @brief enumerates the fixpoints
+          * @param Found called with each batch of fixpoints found
+          * @param Options limits of the search
+          * @param function returns true when the search must stop, checked often, may be empty
+          *
+          */
+        Result run (Found found, const Options& options = Options(), std::function<bool ()> cancelled = std::function<bool ()>());
+
+	private:
+
+        /**
+          * @brief processes of sort s: offset[s] to offset[s + 1] - 1, numbered by sort then process number
+          *
+          */
+        vector<int> offset;
+        vector<int> sortOf;
+
+        /**
+          * @brief processes which hit themselves, never active in a fixpoint
+          *
+          */
+        vector<bool> alone;
+
+        /**
+          * @brief processes forbidden with process p: forbidden[first[p]] to forbidden[first[p + 1] - 1]
+          *
+          */
+        vector<int> first;
+        vector<int> forbidden;
+
+        /**
+          * @brief a node of the search: processes left (one bit each), and their number by sort
+          *
+          */
+        struct Node {
+            vector<uint64_t> left;
+            vector<int> count;
+        };
+
+        /**
+          * @brief chooses a process, then the processes of the sorts left with only one
+          * @return false if a sort has no process left
+          *
+          */
+        bool choose (Node& node, int process, vector<int>& queue);
+
+        /**
+          * @brief the sort to be split next, the one with fewest processes left (-1 if all have one)
+          *
+          */
+        int nextSort (const Node& node);
+
+        /**
+          * @brief the state of a node in which each sort has one process left
+          *
+          */
+        State state (const Node& node);
+
+        friend class FixpointsWorker;
+        friend struct FixpointsSearch;
+};
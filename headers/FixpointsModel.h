@@ -0,0 +1,92 @@
+#pragma once
+#include <QAbstractTableModel>
+#include <QMutex>
+#include <QStringList>
+#include <QTimer>
+#include "Fixpoints.h"
+#include "PH.h"
+
+/**
+  * @file FixpointsModel.h
+  * @brief header for the FixpointsModel class
+  * @author PGROU_2013
+  *
+  */
+
+
+/**
+  * @class FixpointsModel
+  * @brief the fixpoints of a process hitting, one by row and one sort by column, to be shown in a QTableView
+  * @details the fixpoints are added from the threads of the search (see Fixpoints), and the rows are inserted
+  * in the GUI thread a few times a second, by batches. The cells are only computed when displayed
+  *
+  */
+class FixpointsModel : public QAbstractTableModel {
+
+    Q_OBJECT
+
+	public:
+
+        /**
+          * @brief constructor, the sorts of the PH being the columns
+          *
+          */
+        FixpointsModel (PHPtr ph, QObject* parent = 0);
+
+        /**
+          * @brief adds fixpoints, from any thread, the rows being inserted later
+          *
+          */
+        void add (const vector<Fixpoints::State>& fixpoints);
+
+        /**
+          * @brief the process hitting the fixpoints belong to
+          *
+          */
+        PHPtr getPH (void);
+
+        /**
+          * @brief the fixpoint of a row
+          *
+          */
+        Fixpoints::State getState (int row);
+
+        int rowCount (const QModelIndex& parent = QModelIndex()) const;
+        int columnCount (const QModelIndex& parent = QModelIndex()) const;
+        QVariant data (const QModelIndex& index, int role = Qt::DisplayRole) const;
+        QVariant headerData (int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+	public slots:
+
+        /**
+          * @brief inserts the rows of the fixpoints added so far
+          *
+          */
+        void flush (void);
+
+        /**
+          * @brief inserts the last rows, once the search is over
+          *
+          */
+        void finish (void);
+
+	private:
+
+        PHPtr ph;
+        QStringList sorts;
+
+        /**
+          * @brief the processes of the rows, one after another
+          *
+          */
+        vector<int> rows;
+
+        /**
+          * @brief the fixpoints added but not inserted yet, guarded by the mutex
+          *
+          */
+        vector<int> pending;
+        QMutex mutex;
+
+        QTimer timer;
+};
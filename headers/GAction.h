@@ -19,7 +19,6 @@
 class GAction;
 typedef boost::shared_ptr<GAction> GActionPtr;
 class Action;
-typedef boost::shared_ptr<Action> ActionPtr;
 class PHScene;
 
 using std::pair;
@@ -37,20 +36,20 @@ class GAction {
     /**
       * @brief constructor
       *
-      * @param ActionPtr the related Action object
+      * @param int the index of the related Action in the PH
       * @param GVEdge the object that contains style and layout info for hit arrow
       * @param GVEdge the object that contains style and layout info for bounce (result) arrow
       * @param PHScene the related scene
       */
-	GAction(ActionPtr a, GVEdge e, GVEdge f, PHScene* sc);
+	GAction(int a, GVEdge e, GVEdge f, PHScene* sc);
 
     /**
       * @brief constructor
       *
-      * @param ActionPtr the related Action object
+      * @param int the index of the related Action in the PH
       * @param PHScene the related scene
       */
-	GAction(ActionPtr a, PHScene* sc);
+	GAction(int a, PHScene* sc);
 
 	GAction();
 
@@ -73,7 +72,19 @@ class GAction {
           * @brief gets the action
           *
           */
-        ActionPtr getAction();
+        Action getAction();
+
+        /**
+          * @brief moves the GAction to another index, when the actions of the process hitting are renumbered
+          *
+          */
+        void setIndex(int a);
+
+        /**
+          * @brief highlights the action, e.g. while replaying a path of the process hitting
+          *
+          */
+        void setHighlighted(bool on);
 
         /**
           * @brief gets the source GProcess item
@@ -149,10 +160,22 @@ class GAction {
        /*QLineF* targetToResult;**/
 
         /**
-          * @brief the related Action
+          * @brief the index of the related Action in the PH
+          *
+          */
+        int action;
+
+        /**
+          * @brief whether the action is highlighted, which survives updates of its position
+          *
+          */
+        bool highlighted;
+
+        /**
+          * @brief sets the pen of the hit line, according to the kind of the action and to highlighted
           *
           */
-        ActionPtr action;
+        void applyPen();
 
         /**
           * @brief the pair of graphical items representing the tails of the arrows of the Action
@@ -2,6 +2,7 @@
 #include <QGraphicsItem>
 #include <QGraphicsEllipseItem>
 #include <QGraphicsTextItem>
+#include <QBrush>
 #include <list>
 #include "PH.h"
 #include "Process.h"
@@ -15,7 +16,7 @@
 class GProcess;
 typedef boost::shared_ptr<GProcess> GProcessPtr;
 class Process;
-typedef boost::shared_ptr<Process> ProcessPtr;
+typedef Process* ProcessPtr;
 
 
 /**
@@ -46,6 +47,12 @@ class GProcess {
           */
         ProcessPtr* getProcess();
 
+        /**
+          * @brief binds the GProcess to another version of its Process, see GSort::setSort
+          *
+          */
+        void setProcess(ProcessPtr p);
+
         /**
           * @brief gets the display
           *
@@ -59,6 +66,12 @@ class GProcess {
           */
         QGraphicsEllipseItem* getEllipseItem();
 
+        /**
+          * @brief highlights the process as active, e.g. while replaying a path of the process hitting
+          *
+          */
+        void setHighlighted(bool on);
+
         /**
           * @brief gets the rect item that represents the margin of this GProcess
           *
@@ -140,6 +153,13 @@ class GProcess {
           */
         QGraphicsRectItem* marginRect;
 
+        /**
+          * @brief whether the process is highlighted, and the brush of its ellipse before
+          *
+          */
+        bool highlighted;
+        QBrush brush;
+
         /**
           * @brief arbitrarily-chosen key for "margin item" data
           *
@@ -95,6 +95,14 @@ class GSort : public QGraphicsRectItem {
           */
         SortPtr getSort();
 
+        /**
+          * @brief binds the GSort and its GProcess children to another version of its Sort
+          * @details the Sort must have as many processes, position and style are kept
+          *
+          * @param SortPtr the Sort of the new version of the process hitting
+          */
+        void setSort(SortPtr s);
+
         /**
           * @brief gets the related Node object
           *
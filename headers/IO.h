@@ -1,4 +1,6 @@
 #pragma once
+#include <functional>
+#include <ostream>
 #include <string>
 
 /**
@@ -22,7 +24,7 @@ class IO {
         IO() {}
 
         /**
-          * @brief reads file content
+          * @brief reads file content, gzip-compressed files (.ph.gz) being decompressed
           * @param string the path of the file to read
           * @return string file content
           *
@@ -38,10 +40,42 @@ class IO {
         static void fileLocationCheck (string const& path);
 
         /**
-          * @brief Writes the content in the file
+          * @brief Writes the content in the file, compressed with gzip if its name ends with .gz
           * @param string the path of the file to write in
           * @param string the text content to write
           */
         static void writeFile (string const& path, string const& content);
 
+        /**
+          * @brief writes a file through the given writer, compressed with gzip if its name ends with .gz
+          * @details the content is compressed as it is written, io_error is thrown if the file cannot be written
+          * @param string the path of the file to write in
+          * @param function called with the stream to write the content to
+          */
+        static void writeStream (string const& path, const std::function<void (std::ostream&)>& writer);
+
+        /**
+          * @brief whether the content is compressed with gzip
+          *
+          */
+        static bool isCompressed (const char* content, size_t length);
+
+        /**
+          * @brief decompresses gzip content, e.g. a mapped .ph.gz file
+          * @details the whole decompressed content is held in memory, the parsers need it at once.
+          * Throws io_error if the content is corrupted
+          * @param char* the compressed content
+          * @param size_t the length of the compressed content
+          * @return string the decompressed content
+          */
+        static string decompress (const char* content, size_t length);
+
+        /**
+          * @brief writes a number the way PH files expect it, with a dot even if it is an integer (5.)
+          * @param ostream the stream to write to
+          * @param double the number to write
+          * @param int the number of significant digits: 9 keep a float exact, 17 a double
+          */
+        static void writeDecimal (std::ostream& out, double value, int digits);
+
 };
@@ -0,0 +1,124 @@
+#pragma once
+#include <QMap>
+#include <QWidget>
+#include <QTimer>
+#include "AnalysisJob.h"
+
+class QPushButton;
+class QTextEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+  * @file JobsPanel.h
+  * @brief header for the JobsPanel class
+  * @author PGROU_2013
+  *
+  */
+
+
+/**
+  * @class JobsPanel
+  * @brief lists the analysis jobs (see AnalysisJob), with their state and elapsed time
+  * @details the output of the selected job is shown as it is written, and running jobs may be cancelled.
+  * The panel owns the jobs, which are kept once done until cleared
+  *
+  */
+class JobsPanel : public QWidget {
+
+    Q_OBJECT
+
+	public:
+
+        /**
+          * @brief constructor
+          *
+          */
+        JobsPanel (QWidget* parent = 0);
+
+        /**
+          * @brief adds a job to the list and selects it, the job is not started
+          * @param AnalysisJob the job, the panel takes it
+          *
+          */
+        void addJob (AnalysisJob* job);
+
+        /**
+          * @brief number of jobs still running
+          *
+          */
+        int countRunning (void);
+
+    signals:
+
+        /**
+          * @brief emitted when a job is over (finished, failed or cancelled)
+          *
+          */
+        void jobDone (AnalysisJob* job);
+
+	public slots:
+
+        /**
+          * @brief cancels the selected job
+          *
+          */
+        void cancelSelected (void);
+
+        /**
+          * @brief removes the jobs which are over from the list
+          *
+          */
+        void clearDone (void);
+
+	private slots:
+
+        /**
+          * @brief appends what the job which sent the signal wrote, if it is the selected one
+          *
+          */
+        void jobOutput (QString text, bool error);
+
+        /**
+          * @brief updates the line of the job which sent the signal
+          *
+          */
+        void jobStateChanged (void);
+
+        /**
+          * @brief shows the output of the selected job
+          *
+          */
+        void selectionChanged (void);
+
+        /**
+          * @brief updates the elapsed time of the running jobs
+          *
+          */
+        void tick (void);
+
+	private:
+
+        /**
+          * @brief the selected job, NULL if none
+          *
+          */
+        AnalysisJob* selected (void);
+
+        void updateItem (QTreeWidgetItem* item, AnalysisJob* job);
+
+        QTreeWidget* list;
+        QTextEdit* output;
+        QPushButton* cancelButton;
+        QPushButton* clearButton;
+        QMap<AnalysisJob*, QTreeWidgetItem*> items;
+
+        /**
+          * @brief length of the output of each job delivered by its output signal so far,
+          * and length of the output of the selected job shown
+          *
+          */
+        QMap<AnalysisJob*, int> received;
+        int shown;
+        QTimer timer;
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <QMutex>
+#include <QtGlobal>
+#include "PH.h"
+#include "Reachability.h"
+
+/**
+  * @file LocalCausality.h
+  * @brief header for the LocalCausality class
+  * @author PGROU_2013
+  *
+  */
+
+using std::vector;
+
+
+/**
+  * @class LocalCausality
+  * @brief tells statically whether some processes can be active together, without exploring the global states
+  * @details reaching process j of a sort currently at process i is an objective, whose solutions are the paths
+  * from i to j among the actions hitting that sort, each action requiring its hitter to be reached first.
+  * The solutions of each objective are computed once and kept, for all the queries.
+  * Two approximations of the reachability follow, each one only conclusive one way:
+  * - a process can only be reached if it is initially active, or if an action which has it as result has both
+  *   its hitter and its target reachable (a least fixpoint, computed by the constructor): a goal with a process
+  *   out of it is unreachable;
+  * - a goal is reachable if its processes can be reached one after another by playing the solutions of their
+  *   objectives from the initial state, the requirements being reached recursively: the actions played are
+  *   checked on the state, so that success gives a path to the goal.
+  * Otherwise the answer is unknown, and the states must be explored (see Reachability).
+  * The model is copied by the constructor, so that the queries may run in the background while the PH is edited
+  *
+  */
+class LocalCausality {
+
+	public:
+
+        /**
+          * @brief what the analysis found
+          *
+          */
+        struct Result {
+            Reachability::Answer    answer;
+            vector<int>             witness;    //!< if reachable, indexes of the actions played from the initial state to reach the goal
+            qint64                  elapsed;    //!< in microseconds
+            Result (void);
+        };
+
+        /**
+          * @brief copies the sorts, initial state and actions of a process hitting, and finds the processes which may be reached
+          *
+          */
+        LocalCausality (PH& ph);
+
+        /**
+          * @brief tells whether processes can be active together, starting from the initial state
+          * @details may be called by several threads at once
+          * @param vector the processes to be active together (see Reachability::parseGoal)
+          *
+          */
+        Result run (const vector<Reachability::Requirement>& goal);
+
+        /**
+          * @brief false if a process can never be active (over-approximation)
+          *
+          */
+        bool isPossible (int sort, int process);
+
+        /**
+          * @brief number of objectives whose solutions are kept
+          *
+          */
+        int countObjectives (void);
+
+	private:
+
+        /**
+          * @brief an action changing a sort: the sort, its target and result, its hitter, and its index in the PH
+          *
+          */
+        struct Transition {
+            int sort;
+            int target;
+            int result;
+            int hitterSort;
+            int hitter;
+            int action;
+        };
+
+        /**
+          * @brief processes of sort s: offset[s] to offset[s + 1] - 1, the transitions from process p being
+          * transitions[first[p]] to transitions[first[p + 1] - 1]
+          *
+          */
+        vector<int> offset;
+        vector<int> first;
+        vector<Transition> transitions;
+
+        /**
+          * @brief the number of the initially active process of each sort
+          *
+          */
+        vector<int> initial;
+
+        /**
+          * @brief the processes which may be reached (least fixpoint)
+          *
+          */
+        vector<bool> possible;
+
+        /**
+          * @brief an objective: sort, process from, process to
+          *
+          */
+        typedef std::pair<int, std::pair<int, int> > Objective;
+
+        /**
+          * @brief a solution: the transitions played in turn
+          *
+          */
+        typedef vector<int> Solution;
+
+        /**
+          * @brief the solutions of the objectives met so far, guarded by the mutex
+          *
+          */
+        std::map<Objective, vector<Solution> > solutions;
+        QMutex mutex;
+
+        /**
+          * @brief the solutions of an objective, shortest first, computed on the first call
+          *
+          */
+        const vector<Solution>& solve (const Objective& objective);
+
+        /**
+          * @brief plays the solutions of an objective from a state, the requirements being reached first
+          * @param vector the state, changed only on success
+          * @param vector the actions played, appended to on success
+          * @param vector the objectives being reached, which must not be met again
+          * @param int the number of solutions which may still be tried
+          * @return true if the sort is at the process in the end
+          *
+          */
+        bool reach (vector<int>& state, int sort, int process, vector<int>& trace, vector<Objective>& stack, int& budget);
+};
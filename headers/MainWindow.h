@@ -5,6 +5,18 @@
 #include "ConnectionSettings.h"
 #include <vector>
 #include "FunctionForm.h"
+#include <QMap>
+#include <boost/weak_ptr.hpp>
+
+class Area;
+class ModelLoader;
+class AnalysisJob;
+class JobsPanel;
+class LocalCausality;
+class QDockWidget;
+class QModelIndex;
+class QTableView;
+class QProgressDialog;
 
 /**
   * @file MainWindow.h
@@ -38,6 +50,19 @@ public:
 
     ~MainWindow();
 
+    /**
+      * @brief draws a model already parsed and laid out in a new tab
+      * @details throws exception_base if the model cannot be drawn
+      *
+      * @param QString the path of the file of the model
+      * @param PHPtr the model
+      * @param QList<GVNode> the layout of its skeleton graph, see PH::layoutSkeleton
+      * @param QString the content of the file, for the text area
+      * @return Area* the area of the new tab
+      *
+      */
+    Area* addTab(const QString& path, PHPtr ph, const QList<GVNode>& layout, const QString& text);
+
     /**
       * @brief gets centraleArea
       *
@@ -54,11 +79,12 @@ public:
 
     //method for the menu computation
     /**
-      * @brief calls the pint prConnectionSettings()ogram with the given arguments
+      * @brief calls the pint program with the given arguments
+      * @details the program runs in the background, its output is shown in the jobs panel as it comes
       *
       * @param Qstring the program to execute
       * @param QStringList the arguments to give to the program
-      * @param QString (optional) the name of the PH file to parse
+      * @param QString (optional) the name of the PH file analysed, the one of the current tab by default
       *
       */
     void compute(QString program, QStringList arguments, QString fileName="");
@@ -149,11 +175,110 @@ protected:
 
     // action for the menu Help
     QAction *actionHelp;
+    QMenu *menuTimings;
+    QAction *actionRecordTimings;
+    QAction *actionShowTimings;
+    QAction *actionExportTimings;
 
 private :
 
     int displayMode;
 
+    /**
+      * @brief files being loaded, with the stage they reached
+      *
+      */
+    QMap<ModelLoader*, int> loading;
+
+    /**
+      * @brief number of files loaded since the progress dialog was shown
+      *
+      */
+    int loaded;
+
+    /**
+      * @brief progress of all the files being loaded, NULL when there is none
+      *
+      */
+    QProgressDialog* loadingDialog;
+
+    /**
+      * @brief forgets a loader once it is done
+      *
+      */
+    void closeLoading(ModelLoader* loader);
+
+    /**
+      * @brief the analysis jobs, in a dock widget
+      *
+      */
+    JobsPanel* jobsPanel;
+    QDockWidget* jobsDock;
+
+    /**
+      * @brief the fixpoints of the last search (see FixpointsModel), in a dock widget
+      *
+      */
+    QTableView* fixpointsView;
+    QDockWidget* fixpointsDock;
+
+    /**
+      * @brief the static analysis of the last model whose reachability was computed, with the solutions found so far
+      *
+      */
+    boost::shared_ptr<LocalCausality> causality;
+    boost::weak_ptr<PH> causalityModel;
+
+    /**
+      * @brief shows the progress of the files being loaded, closes the dialog when there is none
+      *
+      */
+    void updateLoadingDialog();
+
+private slots:
+
+    /**
+      * @brief updates the progress dialog of the loader which sent the signal
+      *
+      */
+    void loadingProgress(int stage);
+
+    /**
+      * @brief makes the tab of the model loaded by the loader which sent the signal
+      *
+      */
+    void loadingFinished();
+
+    /**
+      * @brief tells the user why the file could not be loaded
+      *
+      */
+    void loadingFailed(QString message);
+
+    /**
+      * @brief forgets the loader which sent the signal
+      *
+      */
+    void loadingCancelled();
+
+    /**
+      * @brief cancels the loading of all the files
+      *
+      */
+    void cancelLoading();
+
+    /**
+      * @brief tells the user in the status bar that a job is over
+      *
+      */
+    void jobDone(AnalysisJob* job);
+
+    /**
+      * @brief highlights the fixpoint of a row in the tab of its model, called when the row is clicked
+      *
+      */
+    void showFixpoint(const QModelIndex& index);
+
 signals:
 
 public slots:
@@ -161,12 +286,20 @@ public slots:
     //menu file
 
     /**
-      * @brief opens a new tab
+      * @brief asks for files, then opens each of them in a new tab
+      *
+      */
+    void openTab();
+
+    /**
+      * @brief loads the files in the background, then opens each of them in a new tab
+      * @details files are parsed and laid out at once by the pool of the loaders (see ModelLoader),
+      * a tab is made as soon as its file is loaded
       *
-      * @return MyArea* pointer to newly created MyArea object
+      * @param QStringList the paths of the files to open
       *
       */
-    MyArea* openTab();
+    void openFiles(const QStringList& files);
 
     /**
       * @brief saves the file
@@ -289,13 +422,16 @@ public slots:
     //menu computation
 
     /**
-      * @brief executes pint program: ph-stable
+      * @brief lists the fixpoints of the model of the current tab as they are found, in the fixpoints dock
+      * @details the fixpoints are searched by several threads (see Fixpoints), as a job of the jobs panel
       *
       */
     void findFixpoints();
 
     /**
-      * @brief executes pint program: ph-reach
+      * @brief tells whether some processes can be active together, in the jobs panel
+      * @details the model of the current tab is first analysed statically (see LocalCausality), and only when
+      * that is not conclusive are its states explored by several threads (see Reachability)
       *
       */
     void computeReachability();
@@ -342,4 +478,24 @@ public slots:
 
     void openConnectionForm();
 
+    //menu help
+
+    /**
+      * @brief starts or stops recording the duration of the phases (parsing, layout...)
+      *
+      */
+    void recordTimings(bool onOff);
+
+    /**
+      * @brief shows the duration of the phases recorded so far
+      *
+      */
+    void showTimings();
+
+    /**
+      * @brief exports the phases recorded so far as a Chrome trace
+      *
+      */
+    void exportTimings();
+
     };
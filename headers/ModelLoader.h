@@ -0,0 +1,179 @@
+#pragma once
+#include <QAtomicInt>
+#include <QList>
+#include <QObject>
+#include <QSemaphore>
+#include <QString>
+#include <QThreadPool>
+#include "GVNode.h"
+#include "PH.h"
+
+/**
+  * @file ModelLoader.h
+  * @brief header for the ModelLoader class
+  * @author PGROU_2013
+  *
+  */
+
+
+/**
+  * @class ModelLoader
+  * @brief loads a PH file in stages, parsing and layout being run by a worker thread
+  * @details the loader reports the stage it reaches and may be cancelled between stages.
+  * Once done, the model and the layout of its skeleton graph are handed back to the GUI thread,
+  * which draws the scene (see PH::render). Loaders share a pool of one thread per core, so
+  * that several files are loaded at once
+  *
+  */
+class ModelLoader : public QObject {
+
+    Q_OBJECT
+
+	public:
+
+        /**
+          * @brief stages of the loading, in order
+          *
+          */
+        enum Stage { Reading, Parsing, Layout, Drawing, StageCount };
+
+        /**
+          * @brief constructor
+          * @param QString the path of the PH file to load
+          *
+          */
+        ModelLoader (const QString& path, QObject* parent = 0);
+
+        /**
+          * @brief destructor, waits for the worker thread to stop
+          *
+          */
+        ~ModelLoader ();
+
+        /**
+          * @brief starts loading in a worker thread of the pool, as soon as one is free
+          *
+          */
+        void start (void);
+
+        /**
+          * @brief the threads shared by the loaders, as many as cores
+          *
+          */
+        static QThreadPool* pool (void);
+
+        /**
+          * @brief whether cancel() was called
+          *
+          */
+        bool isCancelled (void);
+
+        /**
+          * @brief the path of the loaded file
+          *
+          */
+        QString getPath (void);
+
+        /**
+          * @brief the content of the loaded file, once finished
+          *
+          */
+        QString getText (void);
+
+        /**
+          * @brief the loaded model, once finished
+          *
+          */
+        PHPtr getPH (void);
+
+        /**
+          * @brief the nodes of the skeleton graph of the model as laid out, once finished
+          *
+          */
+        QList<GVNode> getLayout (void);
+
+        /**
+          * @brief when the loading started, as given by Trace::now()
+          *
+          */
+        qint64 getStartTime (void);
+
+        /**
+          * @brief name of a stage, to be displayed
+          *
+          */
+        static QString stageName (int stage);
+
+	public slots:
+
+        /**
+          * @brief asks the loader to stop at the end of the current stage, cancelled() is then emitted
+          *
+          */
+        void cancel (void);
+
+    signals:
+
+        /**
+          * @brief emitted when a stage starts
+          *
+          */
+        void progress (int stage);
+
+        /**
+          * @brief emitted in the GUI thread when the model and its layout are ready
+          *
+          */
+        void finished (void);
+
+        /**
+          * @brief emitted in the GUI thread when the file could not be loaded
+          *
+          */
+        void failed (QString message);
+
+        /**
+          * @brief emitted in the GUI thread when the loading stopped because of cancel()
+          *
+          */
+        void cancelled (void);
+
+        /**
+          * @brief emitted by the worker thread once it is done
+          *
+          */
+        void workerFinished (void);
+
+	private slots:
+
+        /**
+          * @brief called in the GUI thread when the worker is done
+          *
+          */
+        void workerDone (void);
+
+	private:
+
+        friend class ModelLoaderTask;
+
+        /**
+          * @brief the stages run by the worker thread
+          *
+          */
+        void run (void);
+
+        QString path;
+        QString text;
+        PHPtr ph;
+        QList<GVNode> layout;
+        QString error;
+        QAtomicInt cancelRequested;
+        qint64 startTime;
+
+        /**
+          * @brief released by the worker thread once it is done
+          *
+          */
+        QSemaphore stopped;
+        bool started;
+};
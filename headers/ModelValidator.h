@@ -0,0 +1,136 @@
+#pragma once
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QSemaphore>
+#include <QString>
+#include <QTimer>
+
+/**
+  * @file ModelValidator.h
+  * @brief header for the ModelValidator class
+  * @author PGROU_2013
+  *
+  */
+
+
+/**
+  * @class Diagnostic
+  * @brief an error found in the text of a model
+  *
+  */
+struct Diagnostic {
+    int     line;       //!< from 1, 0 if unknown
+    int     column;     //!< in characters from 1, 0 if unknown (the whole line is then marked)
+    QString message;
+};
+
+
+/**
+  * @class ModelValidator
+  * @brief parses the text of a model in the background while it is being edited
+  * @details the text is parsed by a worker thread (with the in-process parser, as PHIO::parseContent) once
+  * the user stopped typing for a while. When the text changed again while the worker was busy, the result
+  * is dropped and the latest text is parsed next, so that the GUI thread never waits for the parser
+  *
+  */
+class ModelValidator : public QObject {
+
+    Q_OBJECT
+
+	public:
+
+        /**
+          * @brief constructor
+          * @param int how long to wait after the last change before parsing, in milliseconds
+          *
+          */
+        ModelValidator (int delay = 400, QObject* parent = 0);
+
+        /**
+          * @brief destructor, waits for the worker thread to stop
+          *
+          */
+        ~ModelValidator ();
+
+        /**
+          * @brief the errors found in the last text validated, empty if it is a valid model
+          *
+          */
+        QList<Diagnostic> getDiagnostics (void);
+
+        /**
+          * @brief parses a text, in the calling thread
+          * @param QByteArray the content of a PH file, in UTF-8
+          * @return the errors found, at most one since parsing stops at the first error
+          *
+          */
+        static QList<Diagnostic> check (const QByteArray& content);
+
+	public slots:
+
+        /**
+          * @brief the text to validate changed, it will be parsed after the delay
+          * @param QString the new text
+          *
+          */
+        void setText (const QString& text);
+
+    signals:
+
+        /**
+          * @brief emitted in the GUI thread when the latest text has been parsed
+          *
+          */
+        void validated (void);
+
+        /**
+          * @brief emitted by the worker thread once it is done
+          *
+          */
+        void workerFinished (void);
+
+	private slots:
+
+        /**
+          * @brief called when the user stopped typing, starts the worker unless it is busy
+          *
+          */
+        void startWorker (void);
+
+        /**
+          * @brief called in the GUI thread when the worker is done
+          *
+          */
+        void workerDone (void);
+
+	private:
+
+        friend class ModelValidatorTask;
+
+        QTimer timer;
+
+        /**
+          * @brief the latest text, and its revision (incremented on each change)
+          *
+          */
+        QByteArray text;
+        int revision;
+
+        /**
+          * @brief the text being parsed by the worker, its revision and the result
+          *
+          */
+        QByteArray input;
+        int inputRevision;
+        QList<Diagnostic> result;
+
+        QList<Diagnostic> diagnostics;
+
+        /**
+          * @brief released by the worker thread once it is done
+          *
+          */
+        QSemaphore stopped;
+        bool busy;
+};
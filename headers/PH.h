@@ -1,10 +1,14 @@
 #pragma once
 #include <list>
+#include <deque>
 #include <map>
+#include <ostream>
 #include <string>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 #include "Action.h"
+#include "ActionTable.h"
 #include "GVSkeletonGraph.h"
 #include "PHScene.h"
 #include "Sort.h"
@@ -19,17 +23,47 @@
 using std::list;
 using std::map;
 using std::string;
+using std::vector;
 using boost::make_shared;
 
 // mutual inclusion
 class Action;
-typedef boost::shared_ptr<Action> ActionPtr;
+class PHDiff;
 
 class PH;
 typedef boost::shared_ptr<PH> PHPtr;
 typedef std::pair<string, SortPtr> SortEntry;
 
 
+/**
+  * @class SortRange
+  * @brief iterates over the sorts of a PH in place, by name, without copying them
+  *
+  */
+class SortRange {
+
+	public:
+
+		class iterator {
+			public:
+				iterator (map<string, SortPtr>::iterator i_) : i(i_) {}
+				SortPtr& operator* () const { return i->second; }
+				iterator& operator++ () { ++i; return *this; }
+				bool operator!= (const iterator& other) const { return i != other.i; }
+			protected:
+				map<string, SortPtr>::iterator i;
+		};
+
+		SortRange (map<string, SortPtr>& sorts_) : sorts(sorts_) {}
+		iterator begin (void) { return iterator(sorts.begin()); }
+		iterator end (void) { return iterator(sorts.end()); }
+		int size (void) { return sorts.size(); }
+
+	protected:
+		map<string, SortPtr>& sorts;
+};
+
+
 
 /**
   * @brief builds skeleton node name for graphviz
@@ -56,16 +90,33 @@ class PH {
 		PH();
 
         /**
-          * @brief adds a sort to the PH
-          * @param SortPtr the sort to add
+          * @brief creates a sort and its processes in the PH, the first process being active
+          * @details gives the sort and its processes the next identifiers,
+          * nothing is created if the PH already has a sort with this name
+          * @param string the name of the sort
+          * @param int the number of the last process of the sort
+          * @return SortPtr the sort, owned by the PH
           */
-		void addSort(SortPtr s);
+		SortPtr addSort(const string& name, int lastProcess);
 
         /**
           * @brief adds an action to the PH
-          * @param ActionPtr the action to add
+          * @param ProcessPtr the source Process of the hit
+          * @param ProcessPtr the target Process of the hit
+          * @param ProcessPtr the result of the hit
+          * @param bool determines whether the rate of the hit is infinite or not
+          * @param double the rate of the hit
+          * @param int the stochasticity absorption of the hit
+          * @return int the index of the action
           */
-	void addAction(ActionPtr a);
+	int addAction(ProcessPtr source, ProcessPtr target, ProcessPtr result, bool infiniteRate, double rate, int sa);
+
+        /**
+          * @brief replaces all the actions of the PH
+          * @details the processes of the table must be identifiers of processes of this PH
+          * @param ActionTable the new actions
+          */
+	void setActionTable(const ActionTable& table);
 
         /**
           * @brief getter for a sort
@@ -74,22 +125,78 @@ class PH {
 	SortPtr getSort(string const&);
 
         /**
-          * @brief getter for the actions of the PH
+          * @brief getter for a sort by its identifier
+          *
+          */
+	SortPtr getSort(int id);
+
+        /**
+          * @brief getter for a process by its identifier
           *
           */
-        list<ActionPtr> getActions(void);
+	ProcessPtr getProcess(int id);
 
         /**
-          * @brief getter for the sorts of the PH
+          * @brief number of sorts, identifiers range from 0 to countSorts() - 1
           *
           */
-        list<SortPtr> getSorts(void);
+	int countSorts(void);
 
         /**
-          * @brief getter for the processes of the PH
+          * @brief number of processes, identifiers range from 0 to countProcesses() - 1
           *
           */
-	list<ProcessPtr> getProcesses(void);		
+	int countProcesses(void);
+
+        /**
+          * @brief getter for an action of the PH
+          * @param int the index of the action
+          *
+          */
+        Action getAction(int index);
+
+        /**
+          * @brief number of actions, indexes range from 0 to countActions() - 1
+          *
+          */
+        int countActions(void);
+
+        /**
+          * @brief getter for the table of the actions of the PH
+          *
+          */
+        const ActionTable& getActionTable(void);
+
+        /**
+          * @brief actions which source, target or result is the given process
+          * @details the indexes are built on the first call after a change, then each call
+          * costs as much as the number of actions returned
+          * @param int the identifier of the process
+          *
+          */
+        ActionRange getActionsBySource(int process);
+        ActionRange getActionsByTarget(int process);
+        ActionRange getActionsByResult(int process);
+
+        /**
+          * @brief actions involving the given sort, as hitter or as target (listed once)
+          * @param int the identifier of the sort
+          *
+          */
+        ActionRange getActionsBySort(int sort);
+
+        /**
+          * @brief getter for the sorts of the PH, by name
+          * @details iterates in place, without building a list
+          *
+          */
+        SortRange getSorts(void);
+
+        /**
+          * @brief getter for the processes of the PH, by identifier
+          *
+          */
+	const vector<ProcessPtr>& getProcesses(void);
 
         /**
           * @brief gives a text representation of the process hitting (as it would be in a .ph file)
@@ -103,6 +210,19 @@ class PH {
           */
         string toDotString (void);
 
+        /**
+          * @brief writes the process hitting as a .ph file, action by action
+          * @details memory use does not depend on the size of the model, unlike toString
+          * @param ostream the stream to write to, e.g. a file
+          */
+        void write (std::ostream& out);
+
+        /**
+          * @brief writes the process hitting in .dot format, action by action
+          * @param ostream the stream to write to, e.g. a file
+          */
+        void writeDot (std::ostream& out);
+
         /**
           * @brief calls for the process hitting in its scene
           * @details time-expensive method, calls the toGVGraph method
@@ -110,9 +230,37 @@ class PH {
           */
 	void render (void);
 
+        /**
+          * @brief draws the process hitting in its scene from a layout already computed
+          * @details must be called from the GUI thread, unlike layoutSkeleton
+          * @param QList<GVNode> the nodes of the skeleton graph, as given by layoutSkeleton
+          *
+          */
+	void render (const QList<GVNode>& layout);
+
+        /**
+          * @brief draws the process hitting by patching the scene of its previous version, see PHScene::patch
+          * @details the scene is taken from the previous version; graphviz is only called when sorts were added,
+          * to place them, the other sorts staying where they are
+          * @param PH the previous version, which is left without scene
+          * @param PHDiff the differences from the previous version
+          *
+          */
+	void render (PH& previous, const PHDiff& diff);
+
+        /**
+          * @brief lays out the skeleton graph of the ph model
+          * @details may be called from any thread: graphviz is not reentrant, so the calls
+          * are serialized, and the graph is freed before returning
+          * @return QList<GVNode> the nodes of the skeleton graph, with their position and size
+          *
+          */
+	QList<GVNode> layoutSkeleton (void);
+
         /**
           * @brief make the skeletonGraph related to the ph model
-          * @details calls graphviz to calculate the optimized graph
+          * @details calls graphviz to calculate the optimized graph, does not touch the scene
+          * so that it can be called from a worker thread
           * @return GVSkeletonGraphPtr pointer to the Graph built representing the skeleton
           *
           */
@@ -194,11 +342,44 @@ class PH {
           */
 		map<string, SortPtr> sorts;
 
+        /**
+          * @brief the sorts, indexed by their identifiers
+          *
+          */
+		vector<SortPtr> sortsById;
+
+        /**
+          * @brief the processes, indexed by their identifiers
+          *
+          */
+		vector<ProcessPtr> processesById;
+
         /**
           * @brief list of the actions
           *
           */
-		list<ActionPtr> actions;
+		ActionTable actions;
+
+        /**
+          * @brief indexes of the actions by process (source, target, result) and by sort
+          *
+          */
+		ActionIndex actionsBySource;
+		ActionIndex actionsByTarget;
+		ActionIndex actionsByResult;
+		ActionIndex actionsBySort;
+
+        /**
+          * @brief false when actions or sorts changed since the indexes were built
+          *
+          */
+		bool indexed;
+
+        /**
+          * @brief builds the indexes of the actions if needed
+          *
+          */
+		void index (void);
 		
 		//Display
 
@@ -208,4 +389,14 @@ class PH {
           */
 		PHScenePtr scene;		
 
+		//Storage
+
+        /**
+          * @brief the sorts and processes, stored in bulk: their addresses do not change
+          * @details declared after the scene so that they are destroyed before it
+          *
+          */
+		std::deque<Sort> sortArena;
+		std::deque<Process> processArena;
+
 };
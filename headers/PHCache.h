@@ -0,0 +1,107 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include "PH.h"
+
+/**
+  * @file PHCache.h
+  * @brief header for the PHCache class
+  * @author PGROU_2013
+  *
+  */
+
+
+/**
+  * @class PHCache
+  * @brief stores parsed PH models as compiled binary files (.phb), so that unchanged files
+  * are not parsed and expanded again when they are reopened
+  * @details a compiled model holds the headers, the sorts, the initial state and the action table.
+  * It is named after the SHA-1 of the source content, and is ignored if it was written with another
+  * format or expander version. The cache directory is kept under maxSize, the oldest compiled models
+  * being removed first. Models are only stored when a file is opened in the GUI (see ModelLoader), so that
+  * validations and batch runs do not write to the cache
+  *
+  */
+class PHCache {
+
+	public:
+
+        /**
+          * @brief version of the compiled model format, to be increased whenever it changes
+          *
+          */
+        static const int formatVersion = 1;
+
+        /**
+          * @brief size of the cache directory, in bytes, above which the oldest compiled models are removed
+          *
+          */
+        static const qint64 maxSize = 256 << 20;
+
+        /**
+          * @brief computes the key of a PH file content
+          * @param char* the content of the PH file
+          * @param size_t the length of the content
+          * @return QByteArray the SHA-1 of the content
+          *
+          */
+        static QByteArray key (const char* content, size_t length);
+
+        /**
+          * @brief directory where the compiled models are stored: the PAPPL_CACHE_DIR environment variable
+          * if it is set, ~/.pappl/cache otherwise
+          * @details empty if PAPPL_CACHE_DIR is set but empty, which disables the cache
+          *
+          */
+        static QString directory (void);
+
+        /**
+          * @brief path of the compiled model of the given key
+          *
+          */
+        static QString pathFor (const QByteArray& key);
+
+        /**
+          * @brief loads the compiled model of the given key from the cache directory
+          * @return PHPtr the model, or a null pointer if there is no valid compiled model or the cache is disabled
+          *
+          */
+        static PHPtr load (const QByteArray& key);
+
+        /**
+          * @brief saves the model in the cache directory, unless the cache is disabled, failures are silently ignored
+          *
+          */
+        static void store (const QByteArray& key, PHPtr ph);
+
+        /**
+          * @brief removes the oldest compiled models until the cache directory holds at most the given size,
+          * as well as the files left by interrupted writes
+          *
+          */
+        static void prune (qint64 size);
+
+        /**
+          * @brief reads a compiled model, the file is mapped rather than read
+          * @param QString the path of the compiled model
+          * @param QByteArray the key the compiled model has to match
+          * @return PHPtr the model, or a null pointer if the file is missing, stale or corrupted
+          *
+          */
+        static PHPtr read (const QString& path, const QByteArray& key);
+
+        /**
+          * @brief writes a compiled model
+          * @details the file is written aside under a unique name then renamed over the former one, so that readers
+          * never see it half written or missing, and concurrent writers do not overwrite each other's file
+          * @param QString the path of the compiled model
+          * @param QByteArray the key of the source content
+          * @param PHPtr the model to compile
+          * @return bool true if the file was written
+          *
+          */
+        static bool write (const QString& path, const QByteArray& key, PHPtr ph);
+
+	private:
+        PHCache() {}
+};
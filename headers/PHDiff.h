@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "PH.h"
+
+/**
+  * @file PHDiff.h
+  * @brief header for the PHDiff class
+  * @author PGROU_2013
+  *
+  */
+
+using std::string;
+using std::vector;
+
+
+/**
+  * @class PHDiff
+  * @brief differences between two versions of a process hitting, e.g. before and after an edition of its text
+  * @details sorts are matched by name, actions by their hitter, target and result (sort names and process
+  * numbers), so that the parts of the scene which did not change can be kept (see PHScene::patch)
+  *
+  */
+class PHDiff {
+
+	public:
+
+        /**
+          * @brief compares two versions of a process hitting
+          * @param PH the previous version
+          * @param PH the new version
+          *
+          */
+        PHDiff (PH& before, PH& after);
+
+        /**
+          * @brief names of the sorts only in the new version
+          *
+          */
+        vector<string> addedSorts;
+
+        /**
+          * @brief names of the sorts only in the previous version
+          *
+          */
+        vector<string> removedSorts;
+
+        /**
+          * @brief names of the sorts in both versions, but with another number of processes
+          *
+          */
+        vector<string> resizedSorts;
+
+        /**
+          * @brief for each action of the new version, index of the same action in the previous one (-1 if added)
+          *
+          */
+        vector<int> previousActions;
+
+        /**
+          * @brief numbers of actions added and removed, and of actions kept with another rate
+          *
+          */
+        int addedActions, removedActions, changedActions;
+
+        /**
+          * @brief whether the default rate or the stochasticity absorption changed
+          *
+          */
+        bool headersChanged;
+
+        /**
+          * @brief whether a sort kept in the new version starts with another process
+          *
+          */
+        bool initialStateChanged;
+
+        /**
+          * @brief whether the skeleton graph changed: sorts added or removed, or sorts which start or stop hitting each other
+          * @details when it did not, the layout of the previous version is still valid
+          *
+          */
+        bool skeletonChanged;
+
+        /**
+          * @brief whether both versions are the same model
+          *
+          */
+        bool isEmpty (void);
+
+        /**
+          * @brief short description of the differences, e.g. "1 sort added, 3 actions added"
+          *
+          */
+        string summary (void);
+};
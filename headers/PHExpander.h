@@ -0,0 +1,187 @@
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+  * @file PHExpander.h
+  * @brief header for the PHExpander class
+  * @author PGROU_2013
+  *
+  */
+
+using std::map;
+using std::pair;
+using std::set;
+using std::string;
+using std::vector;
+
+
+/**
+  * @class PHExpander
+  * @brief reads the full PH language and expands its macros (COOPERATIVITY, KNOCKDOWN, RM, GRN)
+  * into the same basic instructions as phc -l dump
+  * @details a cooperative sort is named after the sorts it watches (a_and_b), and must not have the name
+  * of a declared sort. GRN is expanded by the rules of phc, but parity is not established yet:
+  * PHIO sends the files using it to phc when it is available (see Result::grn)
+  *
+  */
+class PHExpander {
+
+	public:
+
+        /**
+          * @brief version of the expansion rules, to be increased whenever they change
+          * @details compiled models (see PHCache) made by another version are ignored
+          *
+          */
+        static const int version = 2;
+
+        /**
+          * @brief an action once macros are expanded: hitter -> target result
+          *
+          */
+        struct ActionDecl {
+            string  hitterSort;
+            int     hitter;
+            string  targetSort;
+            int     target;
+            int     result;
+            bool    infiniteRate;
+            double  rate;
+            int     sa;
+        };
+
+        /**
+          * @brief the content of a PH file once macros are expanded
+          *
+          */
+        struct Result {
+
+            /**
+              * @brief headers, as set by the directives
+              *
+              */
+            bool    infiniteDefaultRate;
+            double  defaultRate;
+            int     stochasticityAbsorption;
+
+            /**
+              * @brief declared sorts (including cooperative ones) with the number of their last process
+              *
+              */
+            vector< pair<string, int> > sorts;
+
+            /**
+              * @brief actions, in declaration order
+              *
+              */
+            vector<ActionDecl> actions;
+
+            /**
+              * @brief active process of each sort, sorts not listed start at 0
+              *
+              */
+            map<string, int> initialState;
+
+            /**
+              * @brief true if the content uses the GRN macro
+              *
+              */
+            bool    grn;
+        };
+
+        /**
+          * @brief parses a PH file content and expands its macros
+          * @details throws ph_parse_error (with line and column), sort_not_found or process_not_found
+          * @param char* the beginning of the content
+          * @param char* the end of the content
+          * @return Result the expanded content
+          *
+          */
+        static Result expand (const char* begin, const char* end);
+
+	private:
+
+        /**
+          * @brief a lexical unit of the PH language
+          *
+          */
+        struct Token {
+            enum Type { Name, Number, Symbol, End };
+            Type    type;
+            string  text;
+            int     line;
+            int     column;
+        };
+
+        /**
+          * @brief a node of the state matching formula of COOPERATIVITY (and, or, not, in)
+          *
+          */
+        struct Formula {
+            enum Type { In, And, Or, Not };
+            Type                type;
+            vector<string>      sorts;
+            vector< vector<int> > states;
+            vector<int>         children;
+        };
+
+        PHExpander (const char* begin, const char* end);
+
+        /**
+          * @brief splits the content into tokens, comments (possibly nested) are skipped
+          *
+          */
+        void tokenize (const char* begin, const char* end);
+
+        // token stream helpers
+        const Token& peek (int offset = 0);
+        const Token& next ();
+        bool accept (const string& symbol);
+        void expect (const string& symbol);
+        string expectName ();
+        int expectNumber ();
+        double expectRate (bool& infinite);
+        void fail (const Token& t, const string& message);
+
+        // statements
+        void parseStatement ();
+        void parseDirective ();
+        void parseProcess ();
+        void parseInitialState ();
+        ActionDecl parseAction ();
+        void parseCooperativity ();
+        void parseKnockdown ();
+        void parseRm ();
+        void parseGrn ();
+
+        // COOPERATIVITY helpers
+        vector<string> parseSortList ();
+        vector< vector<int> > parseStates (size_t width);
+        int parseFormula ();
+        int parseConjunction ();
+        int parseFormulaAtom ();
+        void formulaSorts (int formula, vector<string>& sorts);
+        bool holds (int formula, const map<string, int>& state);
+        bool matches (int formula, const map<string, int>& state);
+        string makeCooperativeSort (const vector<string>& sorts, const Token& where);
+        int cooperativeIndex (const vector<string>& sorts, const vector<int>& values);
+        vector<int> cooperativeValues (const vector<string>& sorts, int index);
+
+        // model helpers
+        int lastProcess (const string& sort, const Token& where);
+        void checkProcess (const string& sort, int process, const Token& where);
+        void addAction (const string& hitterSort, int hitter, const string& targetSort, int target, int result);
+        void removeAction (const ActionDecl& a);
+
+        vector<Token> tokens;
+        size_t position;
+        vector<Formula> formulas;
+        Result result;
+        map<string, int> processes;
+        map<string, vector<string> > cooperativeSorts;
+        set<string> knockedDown;
+};
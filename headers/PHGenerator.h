@@ -0,0 +1,77 @@
+#pragma once
+#include <ostream>
+#include <string>
+
+/**
+  * @file PHGenerator.h
+  * @brief header for the PHGenerator class
+  * @author PGROU_2013
+  *
+  */
+
+using std::string;
+
+
+/**
+  * @class PHGenerator
+  * @brief writes synthetic PH files, to test and benchmark the program on models larger than the samples
+  * @details the skeleton graph (which sort hits which) is drawn first, following one of several topologies,
+  * then each of its edges gets actions between processes of the two sorts. Some regulations are written
+  * with the GRN and COOPERATIVITY macros. The output only depends on the options: the same seed always
+  * gives the same file, whatever the platform
+  *
+  */
+class PHGenerator {
+
+	public:
+
+        /**
+          * @brief shape of the skeleton graph
+          *
+          */
+        enum Topology {
+            ScaleFree,  //!< preferential attachment: a few hub sorts hit most of the others
+            Modular,    //!< groups of sorts mostly hitting each other, with a few links between groups
+            Layered     //!< sorts in layers, each one hit by the previous layer only (feed-forward)
+        };
+
+        /**
+          * @brief what to generate
+          *
+          */
+        struct Options {
+            unsigned    seed;
+            int         sorts;          //!< number of (non cooperative) sorts
+            int         processes;      //!< number of processes of a sort, at most (at least 2)
+            double      density;        //!< average number of actions hitting a sort
+            int         regulators;     //!< average number of sorts hitting a sort
+            Topology    topology;
+            int         groups;         //!< number of modules or layers
+            double      macros;         //!< share of the regulations written with macros, in [0, 1]
+            double      rates;          //!< share of the actions having a rate, in [0, 1]
+            Options (void);
+        };
+
+        /**
+          * @brief writes a generated model
+          * @param ostream the stream to write the PH file to
+          * @param Options what to generate
+          * @return int the number of actions written, before the expansion of the macros
+          *
+          */
+        static int write (std::ostream& output, const Options& options);
+
+        /**
+          * @brief generates a model
+          * @return string the PH file
+          *
+          */
+        static string generate (const Options& options);
+
+        /**
+          * @brief reads a topology name: scale-free, modular or layered
+          * @return bool false if the name is unknown
+          *
+          */
+        static bool topologyFromName (const string& name, Topology& topology);
+};
@@ -1,7 +1,10 @@
 #pragma once
 #include <string>
 #include "PH.h"
+#include "PHExpander.h"
 #include "MainWindow.h"
+#include <QByteArray>
+#include <QStringList>
 #include <QXmlStreamWriter>
 
 /**
@@ -31,20 +34,89 @@ class PHIO {
 
         /**
           * @brief parses the file if it is possible
+          * @details an unchanged file opened before in the GUI is loaded from its compiled model (see PHCache),
+          * but the parsed model is not stored
           * @param string the path of the file to parse
           * @return PHPtr pointer to the PH object that results form parsing
           *
           */
 		static PHPtr parseFile  (string const& path);
 
+        /**
+          * @brief parses the content of a PH file, expanding its macros if needed
+          * @param char* the content of the PH file
+          * @param size_t the length of the content
+          * @return PHPtr pointer to the PH object that results form parsing
+          *
+          */
+        static PHPtr parseContent (const char* input, size_t length);
+
+        /**
+          * @brief parses the content of a PH file, expanding all its macros natively
+          * @details unlike parseContent, GRN is never left to phc: kept to compare the expansions
+          * @param char* the content of the PH file
+          * @param size_t the length of the content
+          * @return PHPtr pointer to the PH object that results form parsing
+          *
+          */
+        static PHPtr parseContentNatively (const char* input, size_t length);
+
+        /**
+          * @brief parses the content of a PH file already read (and decompressed), through the cache (see PHCache)
+          * @param char* the content of the PH file
+          * @param size_t the length of the content
+          * @param string the path of the file, given in errors
+          * @param bool true to store the parsed model in the cache, when it was not found there
+          * @return PHPtr pointer to the PH object that results form parsing
+          *
+          */
+        static PHPtr parseCachedContent (const char* input, size_t length, string const& path, bool store);
+
+        /**
+          * @brief parses the file the former way: macros are expanded by phc utility
+          * @details kept as a reference for the native expansion, requires phc
+          * @param string the path of the file to parse
+          * @return PHPtr pointer to the PH object that results form parsing
+          *
+          */
+        static PHPtr parseFileWithPhc (string const& path);
+
+        /**
+          * @brief parses the data dumped by phc utility
+          * @details single pass scanner, errors are thrown with line_info
+          * @param char* the dump to parse, which does not need to be null terminated
+          * @param size_t the length of the dump
+          * @return PHPtr pointer to the PH object that results form parsing
+          *
+          */
+        static PHPtr parse (const char* input, size_t length);
+
+        /**
+          * @brief parses the data dumped by phc utility with the former AXE grammar
+          * @details slower than parse (backtracking), kept as a reference for tests and benchmarks
+          * @param string the dump to parse, each line terminated
+          * @return PHPtr pointer to the PH object that results form parsing
+          *
+          */
+        static PHPtr parseWithAxe (string const& input);
+
         /**
           * @brief saves the PH object as a PH file
+          * @details the file is streamed, io_error is thrown if it cannot be written
           * @param string the path of the file
           * @param PHPtr pointer to the object that will be saved
           *
           */
         static void writeToFile (string const& path, PHPtr ph);
 
+        /**
+          * @brief saves the PH object as a DOT file (graph of the processes and actions)
+          * @param string the path of the file
+          * @param PHPtr pointer to the object that will be saved
+          *
+          */
+        static void writeDotToFile (string const& path, PHPtr ph);
+
         /**
           * @brief saves as a PNG the representation of the PH file as it is displayed in the GUI
           * @param PHPtr pointer to the PH object of the active window
@@ -66,11 +138,50 @@ class PHIO {
 		PHIO(){}
 
         /**
-          * @brief parses the data dumped by phc utility
-          * @param string the dump to parse
-          * @return PHPtr pointer to the PH object that results form parsing
+          * @brief checks that the input only contains basic PH instructions
+          * @details process declarations (one per line), actions, initial state and comments,
+          * i.e. what phc would give back unchanged: such input can be parsed without calling phc
+          * @param char* the content of the PH file
+          * @param size_t the length of the content
+          * @return bool true if the input is in basic form
+          *
+          */
+        static bool isBasicForm (const char* input, size_t length);
+
+        /**
+          * @brief creates the PH object once macros are expanded
+          * @param PHExpander::Result the expanded content
+          * @return PHPtr pointer to the resulting PH object
+          *
+          */
+        static PHPtr build (PHExpander::Result const& expanded);
+
+        /**
+          * @brief calls phc utility to transform the PH file into basic instructions
+          * @param string the path of the file to dump
+          * @return QByteArray the dump, as written by phc
+          *
+          */
+        static QByteArray dumpWithPhc (string const& path);
+
+        /**
+          * @brief calls phc utility to transform the content of a PH file into basic instructions
+          * @param char* the content, given on the standard input of phc
+          * @param size_t the length of the content
+          * @return QByteArray the dump, as written by phc
+          *
+          */
+        static QByteArray dumpWithPhc (const char* input, size_t length);
+
+        /**
+          * @brief runs phc and reads its output
+          * @details throws pint_program_not_found if phc cannot be started, pint_phc_crash if it writes errors
+          * @param QStringList the arguments
+          * @param char* given on the standard input of phc, may be NULL
+          * @param size_t the length of the input
+          * @return QByteArray the standard output of phc
           *
           */
-        static PHPtr parse (string const& input);
+        static QByteArray runPhc (QStringList const& args, const char* input, size_t length);
 
 };
@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "PH.h"
+
+/**
+  * @file PHReplay.h
+  * @brief header for the PHReplay class
+  * @author PGROU_2013
+  *
+  */
+
+using std::string;
+using std::vector;
+
+class PHReplay;
+typedef boost::shared_ptr<PHReplay> PHReplayPtr;
+
+
+/**
+  * @class PHReplay
+  * @brief shows a path of a process hitting in its scene, step by step (e.g. a witness of Reachability)
+  * @details at each step, the active process of each sort is highlighted, as well as the action played next.
+  * Going from a step to another only recolors the items of the sorts which changed in between, so that
+  * moving through the path stays fast on large scenes. The styles are restored once the replay is destroyed
+  *
+  */
+class PHReplay {
+
+	public:
+
+        /**
+          * @brief constructor, shows the initial state (step 0)
+          * @param PHPtr the process hitting, which must be rendered
+          * @param vector the indexes of the actions played, in order, starting from the initial state
+          * @param vector the number of the process of each sort in the initial state, the active ones of the PH if empty
+          *
+          */
+        PHReplay (PHPtr ph, const vector<int>& actions, const vector<int>& initial = vector<int>());
+
+        /**
+          * @brief destructor, removes the highlights
+          *
+          */
+        ~PHReplay ();
+
+        /**
+          * @brief number of actions played, steps ranging from 0 (initial state) to countSteps()
+          *
+          */
+        int countSteps (void);
+
+        /**
+          * @brief the current step
+          *
+          */
+        int getStep (void);
+
+        /**
+          * @brief shows the state after the given number of actions
+          *
+          */
+        void setStep (int step);
+
+        /**
+          * @brief the process hitting replayed
+          *
+          */
+        PHPtr getPH (void);
+
+        /**
+          * @brief the action played at a step (from step to step + 1), as written in a PH file
+          *
+          */
+        string describe (int step);
+
+	private:
+
+        PHPtr ph;
+        vector<int> actions;
+
+        /**
+          * @brief for each action, its target sort and the processes of that sort before and after
+          *
+          */
+        vector<int> sorts;
+        vector<int> before;
+        vector<int> after;
+
+        /**
+          * @brief the active process of each sort at the current step
+          *
+          */
+        vector<int> active;
+        int step;
+
+        /**
+          * @brief highlights or not the active process of a sort, and the action played at a step
+          *
+          */
+        void highlightProcess (int sort, bool on);
+        void highlightAction (int step, bool on);
+};
@@ -5,6 +5,8 @@
 #include <map>
 #include <string>
 #include "GAction.h"
+#include <QList>
+#include "GVNode.h"
 
 
 
@@ -20,6 +22,7 @@ using std::string;
 
 // mutual inclusions
 class PH;
+class PHDiff;
 class GProcess;
 typedef boost::shared_ptr<GProcess> GProcessPtr;
 class GSort;
@@ -55,6 +58,25 @@ class PHScene: public QGraphicsScene {
           */
         void drawFromSkeleton(void);
 
+        /**
+          * @brief draw the PHScene from the layout of its GVSkeletonGraph
+          * @param QList<GVNode> the nodes of the skeleton graph of the PH object, as laid out
+          *
+          */
+        void drawFromSkeleton(const QList<GVNode>& gSkeletonNodes);
+
+        /**
+          * @brief switches the scene to a new version of its process hitting, redrawing only what changed
+          * @details sorts and actions found in both versions keep their items, position and style;
+          * removed ones are dropped, resized sorts are drawn again where they were, and the actions
+          * touching them with it
+          * @param PH* the new version of the process hitting
+          * @param PHDiff the differences from the current version
+          * @param QList<GVNode> where to draw the added sorts (empty if there is none)
+          *
+          */
+        void patch(PH* _ph, const PHDiff& diff, const QList<GVNode>& gSkeletonNodes);
+
         /**
           * @brief gets a GSort by its related Sort's name
           * @param string the name of the (G)Sort to get
@@ -63,17 +85,31 @@ class PHScene: public QGraphicsScene {
           */
 	GSortPtr getGSort (const string& s);
 
+        /**
+          * @brief gets a GSort by its related Sort's identifier
+          * @param int the identifier of the Sort
+          * @return GSortPtr pointer to the GSort to get
+          *
+          */
+	GSortPtr getGSort (int id);
+
+        /**
+          * @brief gets the related process hitting
+          *
+          */
+        PH* getPH();
+
         /**
           * @brief getter for sorts
           *
           */
-        map<string, GSortPtr> getGSorts();
+        const map<string, GSortPtr>& getGSorts();
 
         /**
           * @brief get the processes
           *
           */
-        std::vector<GProcessPtr> getProcesses();
+        const std::vector<GProcessPtr>& getProcesses();
 
         /**
           * @brief get the actions
@@ -81,6 +117,12 @@ class PHScene: public QGraphicsScene {
           */
         std::vector<GActionPtr> getActions();
 
+        /**
+          * @brief get an action by its index in the PH
+          *
+          */
+        GActionPtr getAction(int index);
+
 
         /**
           * @brief update the position of actions
@@ -110,6 +152,12 @@ class PHScene: public QGraphicsScene {
           */
         map<string, GSortPtr> sorts;
 
+        /**
+          * @brief the Sorts drawn in the scene, indexed by the identifiers of the Sorts
+          *
+          */
+        std::vector<GSortPtr> sortsById;
+
         /**
           * @brief vector of the Processes drawn in the scene
           *
@@ -128,4 +176,10 @@ class PHScene: public QGraphicsScene {
           */
         void createActions();
 
+        /**
+          * @brief creates the GSort of a Sort, centered on the node
+          *
+          */
+        GSortPtr makeGSort(SortPtr s, const GVNode& node);
+
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include <boost/shared_ptr.hpp>
+#include <ostream>
 #include <string>
 #include <list>
 #include "Sort.h"
@@ -16,10 +17,10 @@ using std::string;
 
 // mutual inclusion
 class Sort;
-typedef boost::shared_ptr<Sort> SortPtr;
+typedef Sort* SortPtr;
 
 class Process;
-typedef boost::shared_ptr<Process> ProcessPtr;
+typedef Process* ProcessPtr;
 
 class GProcess;
 typedef boost::shared_ptr<GProcess> GProcessPtr;
@@ -54,6 +55,19 @@ class Process {
           */
 		SortPtr getSort(void);
 
+        /**
+          * @brief gets the identifier of the Process in its PH
+          * @return int the identifier, -1 until the Sort is added to a PH
+          *
+          */
+		int getId(void);
+
+        /**
+          * @brief sets the identifier of the Process in its PH
+          *
+          */
+		void setId(const int& i);
+
         /**
           * @brief builds name for DOT files
           * @return string adapted name
@@ -67,6 +81,18 @@ class Process {
           */
 		string toDotString (void);
 
+        /**
+          * @brief writes the name of the process in DOT files, as given by getDotName
+          * @param ostream the stream to write to
+          */
+		void writeDotName (std::ostream& out);
+
+        /**
+          * @brief writes the process as a DOT node
+          * @param ostream the stream to write to
+          */
+		void writeDot (std::ostream& out);
+
         /**
           * @brief sets the related GProcess
           * @param a pointer to the related GProcess object
@@ -95,6 +121,12 @@ class Process {
           */
 		int number;
 
+        /**
+          * @brief dense identifier of the Process among all the Processes of its PH
+          *
+          */
+		int id;
+
         /**
           * @brief a pointer to the related GProcess
           *
@@ -0,0 +1,167 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include <QtGlobal>
+#include "PH.h"
+
+/**
+  * @file Reachability.h
+  * @brief header for the Reachability class
+  * @author PGROU_2013
+  *
+  */
+
+using std::string;
+using std::vector;
+
+
+/**
+  * @class Reachability
+  * @brief explores the global states of a process hitting, to tell whether some processes can be active together
+  * @details a global state gives the active process of each sort, packed in ceil(log2(processes)) bits per sort.
+  * The states reachable from the initial state (the active processes of the sorts) are explored breadth first
+  * by several threads: each level is cut in chunks taken in turn by the threads, and the states already met are
+  * kept in a lock-free hash set, with the state and the action they were first reached from, so that a shortest
+  * path to the goal is given back. The model is copied by the constructor, so that the exploration may run in
+  * the background while the PH is edited
+  *
+  */
+class Reachability {
+
+	public:
+
+        /**
+          * @brief a process required by the goal: identifier of its sort, and its number
+          *
+          */
+        typedef std::pair<int, int> Requirement;
+
+        /**
+          * @brief limits of the exploration
+          *
+          */
+        struct Options {
+            int             threads;    //!< 0 for as many as cores
+            size_t          maxStates;  //!< the exploration stops once that many states are stored
+            Options (void);
+        };
+
+        /**
+          * @brief answers of the exploration
+          *
+          */
+        enum Answer {
+            Reachable,      //!< a reachable state satisfies the goal
+            Unreachable,    //!< all the reachable states were explored, none satisfies the goal
+            Unknown         //!< stopped before (cancelled, or too many states)
+        };
+
+        /**
+          * @brief what the exploration found
+          *
+          */
+        struct Result {
+            Answer  answer;
+            size_t  states;     //!< number of states met
+            int     depth;      //!< number of transitions from the initial state to the state found, else to the farthest states
+            qint64  elapsed;    //!< in milliseconds
+            vector<int> witness;    //!< if reachable, indexes of the actions played from the initial state to reach the goal
+            Result (void);
+        };
+
+        /**
+          * @brief called after each level: depth, then number of states met so far
+          *
+          */
+        typedef std::function<void (int, size_t)> Progress;
+
+        /**
+          * @brief copies the sorts, initial state and actions of a process hitting
+          *
+          */
+        Reachability (PH& ph);
+
+        /**
+          * @brief reads a goal such as "a 1 b 0": sort names, each followed by a process number
+          * @details throws sort_not_found or process_not_found
+          *
+          */
+        static vector<Requirement> parseGoal (PH& ph, const string& goal);
+
+        /**
+          * @brief explores the states reachable from the initial state, until one satisfies the goal
+          * @param vector the processes to be active together
+          * @param Options limits of the exploration
+          * @param Progress called by the calling thread after each level, may be empty
+          * @param function returns true when the exploration must stop, checked often, may be empty
+          *
+          */
+        Result run (const vector<Requirement>& goal, const Options& options = Options()
+                    , Progress progress = Progress(), std::function<bool ()> cancelled = std::function<bool ()>());
+
+        /**
+          * @brief number of 64 bit words of a packed state
+          *
+          */
+        int countWords (void);
+
+        /**
+          * @brief the process of a sort in a packed state
+          *
+          */
+        int get (const uint64_t* state, int sort);
+
+        /**
+          * @brief sets the process of a sort in a packed state
+          *
+          */
+        void set (uint64_t* state, int sort, int process);
+
+        /**
+          * @brief name of an answer, to be displayed
+          *
+          */
+        static string answerName (Answer answer);
+
+	private:
+
+        /**
+          * @brief place of each sort in a packed state: word, first bit and mask (before the shift)
+          *
+          */
+        vector<int> word;
+        vector<int> shift;
+        vector<uint64_t> mask;
+        int words;
+
+        /**
+          * @brief the initial state, packed
+          *
+          */
+        vector<uint64_t> initial;
+
+        /**
+          * @brief a transition: when the target is active, hitter's sort being at hitter, the target sort goes to result
+          *
+          */
+        struct Transition {
+            int hitterSort;
+            int hitter;
+            int result;
+            int action;     //!< index of the action in the PH
+        };
+
+        /**
+          * @brief transitions by target process, the ones of process p of sort s being
+          * transitions[first[offset[s] + p]] to transitions[first[offset[s] + p + 1] - 1]
+          *
+          */
+        vector<int> offset;
+        vector<int> first;
+        vector<Transition> transitions;
+
+        friend class ReachabilityWorker;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <ostream>
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
@@ -20,32 +21,27 @@ using boost::make_shared;
 
 // mutual inclusion
 class Process;
-typedef boost::shared_ptr<Process> ProcessPtr;
+typedef Process* ProcessPtr;
 
 class Sort;
-typedef boost::shared_ptr<Sort> SortPtr;
+typedef Sort* SortPtr;
 
 class GSort;
+class PH;
 
 
 /**
   * @class Sort
   * @brief represents a sort of the process hitting
+  * @details Sorts are created by PH::addSort and owned by their PH
   *
   */
 class Sort {
 
+	friend class PH;
+
 public:
 	
-        /**
-          * @brief creates a pointer to the Sort which name is given as parameter
-          * @param string name of the Sort to created
-          * @param int number of processes in the Sort
-          * @return SortPtr the pointer to the created Sort
-          *
-          */
-		static SortPtr make(const string&, const int&);
-		
 
         /**
           * @brief gets a Process by its index
@@ -55,10 +51,10 @@ public:
 		ProcessPtr getProcess (const uint&);
 
         /**
-          * @brief gets processes vector
+          * @brief gets processes vector, in place
           *
           */
-        vector<ProcessPtr> getProcesses (void);
+        const vector<ProcessPtr>& getProcesses (void);
 
         /**
           * @brief gets the active process
@@ -82,7 +78,20 @@ public:
           * @brief gets the name of the Sort
           *
           */
-		string getName (void);
+		const string& getName (void);
+
+        /**
+          * @brief gets the identifier of the Sort in its PH
+          * @return int the identifier, -1 until the Sort is added to a PH
+          *
+          */
+		int getId (void);
+
+        /**
+          * @brief sets the identifier of the Sort in its PH
+          *
+          */
+		void setId (const int&);
 
         /**
           * @brief gives a text representation of the process hitting (as it would be in a .ph file)
@@ -96,6 +105,18 @@ public:
           */
 		string toDotString(void);
 
+        /**
+          * @brief writes the declaration of the Sort (as it would be in a .ph file)
+          * @param ostream the stream to write to
+          */
+		void write (std::ostream& out);
+
+        /**
+          * @brief writes the Sort and its processes as a DOT cluster
+          * @param ostream the stream to write to
+          */
+		void writeDot (std::ostream& out);
+
 	protected:
 
         /**
@@ -116,6 +137,12 @@ public:
           */
 		string name;
 
+        /**
+          * @brief dense identifier of the Sort in its PH
+          *
+          */
+		int id;
+
         /**
           * @brief Processes of the Sort
           *
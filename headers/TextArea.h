@@ -3,6 +3,9 @@
 
 #include <QTextEdit>
 #include <QColor>
+#include <QList>
+#include <QStringList>
+#include "ModelValidator.h"
 
 /**
   * @class TextArea
@@ -63,8 +66,30 @@ public:
       */
     void decNberTextChange();
 
+    /**
+      * @brief underlines the errors found in the text, replacing the previous ones
+      * @param QList<Diagnostic> the errors, found by a ModelValidator
+      *
+      */
+    void setDiagnostics(const QList<Diagnostic>& diagnostics);
+
+protected :
+
+    /**
+      * @brief shows the message of the error under the mouse as a tool tip
+      *
+      */
+    bool event(QEvent* e);
+
 private :
 
+    /**
+      * @brief the errors underlined, with their place in the document
+      *
+      */
+    QList<QTextEdit::ExtraSelection> errors;
+    QStringList errorMessages;
+
     /**
       * @brief Number of text change in the textArea
       *
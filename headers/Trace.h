@@ -0,0 +1,149 @@
+#pragma once
+#include <string>
+#include <QAtomicInt>
+#include <QString>
+#include <QtGlobal>
+
+/**
+  * @file Trace.h
+  * @brief header for the Trace class
+  * @author PGROU_2013
+  *
+  */
+
+using std::string;
+
+
+/**
+  * @class Trace
+  * @brief records how long the phases of the program (parsing, layout, drawing...) take
+  * @details phases are timed by Trace::Scope objects, usually through the TRACE_SCOPE macro.
+  * Nothing is recorded while tracing is disabled, a scope then only tests a flag.
+  * Records can be exported as Chrome trace events (chrome://tracing) or summed up by phase
+  *
+  */
+class Trace {
+
+	public:
+
+        /**
+          * @class Trace::Scope
+          * @brief times the block it is declared in, as a phase of the given name
+          *
+          */
+        class Scope {
+
+            public:
+
+                /**
+                  * @brief starts timing, if tracing is enabled
+                  * @param char* the name of the phase, which must outlive the trace (a literal)
+                  * @param string details about this occurrence of the phase, e.g. a file name
+                  *
+                  */
+                Scope (const char* name_, const string& detail_ = string()) : name(name_), start(-1) {
+                    if (enabled == 1) {
+                        detail = detail_;
+                        start = now();
+                    }
+                }
+
+                /**
+                  * @brief records the phase, if tracing was enabled when it started
+                  *
+                  */
+                ~Scope () {
+                    stop();
+                }
+
+                /**
+                  * @brief records the phase now rather than at the end of the block
+                  *
+                  */
+                void stop (void) {
+                    if (start >= 0)
+                        record(name, start, detail);
+                    start = -1;
+                }
+
+            private:
+                const char* name;
+                string detail;
+                qint64 start;
+        };
+
+        /**
+          * @brief whether phases are recorded
+          *
+          */
+        static bool isEnabled (void);
+
+        /**
+          * @brief starts or stops recording phases, records already made are kept
+          *
+          */
+        static void setEnabled (bool b);
+
+        /**
+          * @brief microseconds since the program started
+          *
+          */
+        static qint64 now (void);
+
+        /**
+          * @brief records a phase which started at the given time and ends now
+          * @details may be called from any thread
+          * @param char* the name of the phase, which must outlive the trace (a literal)
+          * @param qint64 the start of the phase, as given by now()
+          * @param string details about this occurrence of the phase
+          *
+          */
+        static void record (const char* name, qint64 start, const string& detail = string());
+
+        /**
+          * @brief forgets all the records
+          *
+          */
+        static void clear (void);
+
+        /**
+          * @brief number of records
+          *
+          */
+        static int count (void);
+
+        /**
+          * @brief writes the records as Chrome trace events (JSON object format)
+          * @param QString the path of the file to write
+          * @return bool true if the file was written
+          *
+          */
+        static bool writeChromeTrace (const QString& path);
+
+        /**
+          * @brief sums the records up by phase: count, total, mean and maximum durations
+          * @return QString a plain text table, longest phases first
+          *
+          */
+        static QString summary (void);
+
+	private:
+        Trace() {}
+
+        /**
+          * @brief tested by each scope, in any thread, set by setEnabled (1 if enabled)
+          *
+          */
+        static QAtomicInt enabled;
+};
+
+
+// unique name for the scope variable, so that several scopes may follow each other
+#define TRACE_CONCAT_(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+/**
+  * @brief times the rest of the enclosing block as a phase: TRACE_SCOPE("name") or TRACE_SCOPE("name", detail)
+  *
+  */
+#define TRACE_SCOPE(...) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(__VA_ARGS__)
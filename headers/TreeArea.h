@@ -7,6 +7,8 @@
 #include <QLineEdit>
 #include "MyArea.h"
 
+class PHDiff;
+
 
 /**
   * @class TreeArea
@@ -130,6 +132,13 @@ public slots:
       */
     void build();
 
+    /**
+      * @brief updates the tree after an edition of the model: items of removed sorts are deleted
+      * (from the groups too) and items of added sorts are inserted, the others are kept
+      *
+      */
+    void patch(const PHDiff& diff);
+
     /**
       * @brief search a sort. Slot linked with the search button signal
       *
@@ -0,0 +1,37 @@
+#include <QtTest/QtTest>
+
+/**
+  * @file PHBench.h
+  * @brief header for the PHBench class
+  * @author PGROU_2013
+  */
+
+/**
+  * @class PHBench
+  * @brief measures the main stages of the program on the samples and on synthetic models of increasing size
+  * @details run with -xml (or -lightxml) to get machine-readable results, e.g. bin/pappl-bench -xml -o bench.xml
+  */
+ class PHBench: public QObject {
+    Q_OBJECT
+	private slots:
+		void scan_data();
+		void scan();
+		void parse_data();
+		void parse();
+		void layout_data();
+		void layout();
+		void drawScene_data();
+		void drawScene();
+		void dragSort_data();
+		void dragSort();
+		void exportPNG_data();
+		void exportPNG();
+		void xmlRoundTrip_data();
+		void xmlRoundTrip();
+		void reach_data();
+		void reach();
+		void localCausality_data();
+		void localCausality();
+		void fixpoints_data();
+		void fixpoints();
+ };
@@ -13,6 +13,35 @@
  class PHIOTest: public QObject {
     Q_OBJECT
 	private slots:
+		void initTestCase();
+		void cleanupTestCase();
 		void parse_data();
 		void parse();
+		void expand_data();
+		void expand();
+		void macros_data();
+		void macros();
+		void scan_data();
+		void scan();
+		void compile_data();
+		void compile();
+		void compressed_data();
+		void compressed();
+		void diff_data();
+		void diff();
+		void validate_data();
+		void validate();
+		void analysisJob_data();
+		void analysisJob();
+		void reach_data();
+		void reach();
+		void localCausality_data();
+		void localCausality();
+		void fixpoints_data();
+		void fixpoints();
+		void generate_data();
+		void generate();
+
+	private:
+		QString cacheDirectory;
  };
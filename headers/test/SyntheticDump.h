@@ -0,0 +1,31 @@
+#pragma once
+#include <sstream>
+#include <string>
+
+/**
+  * @file SyntheticDump.h
+  * @brief synthetic models in basic form, for tests and benchmarks
+  */
+
+/**
+  * @brief synthetic dump: sorts of 4 processes, actions with and without rates
+  * @param int the number of sorts
+  * @param int the number of actions
+  * @return string the model, as phc would dump it
+  */
+inline std::string syntheticDump (int sorts, int actions) {
+	std::ostringstream res;
+	res << "(* synthetic model *)\n";
+	for (int i = 0; i < sorts; i++)
+		res << "process s" << i << " 3\n";
+	for (int i = 0; i < actions; i++) {
+		res << "s" << (i * 7) % sorts << " " << i % 4 << " -> s" << (i * 13 + 1) % sorts << " " << (i / 4) % 4 << " " << (i / 16) % 4;
+		if (i % 3 == 1)
+			res << " @" << (i % 10) / 4. << "~" << 1 + i % 5;
+		else if (i % 3 == 2)
+			res << " @Inf";
+		res << "\n";
+	}
+	res << "initial_state s0 1, s1 2\n";
+	return res.str();
+}
@@ -2,23 +2,38 @@ TEMPLATE 	= app
 CONFIG 		+= qt
 DESTDIR 	= bin
 OBJECTS_DIR = .tmp
-LIBS 		= -lboost_filesystem -lboost_system -L/usr/lib/graphviz -lgvc -lgraph -lpathplan -lcdt -lgvplugin_dot_layout
+LIBS 		= -lboost_filesystem -lboost_system -lz -L/usr/lib/graphviz -lgvc -lgraph -lpathplan -lcdt -lgvplugin_dot_layout
 
 HEADERS 	= 	headers/Action.h 		\
+				headers/ActionTable.h 	\
+				headers/AnalysisJob.h 	\
 				headers/Exceptions.h 	\
+				headers/Fixpoints.h 	\
+				headers/FixpointsModel.h 	\
 				headers/IO.h 			\
+				headers/JobsPanel.h 	\
+				headers/LocalCausality.h 	\
 				headers/GProcess.h 		\
 				headers/GAction.h 		\
 				headers/GSort.h 		\
 				headers/GVEdge.h 		\
 				headers/GVNode.h	 	\
 				headers/MainWindow.h 	\
+				headers/ModelLoader.h 	\
+				headers/ModelValidator.h 	\
 				headers/MyArea.h 		\
 				headers/PH.h 			\
 				headers/PHScene.h		\
+				headers/PHReplay.h 		\
+				headers/Reachability.h 	\
+				headers/PHCache.h 		\
+				headers/PHDiff.h 		\
+				headers/PHExpander.h 	\
+				headers/PHGenerator.h 	\
 				headers/PHIO.h 			\
 				headers/Process.h 		\
 				headers/Sort.h \
+    headers/Trace.h \
     headers/Area.h \
     headers/TextArea.h \
     headers/TreeArea.h \
@@ -40,17 +55,32 @@ SOURCES			= 	src/gfx/GProcess.cpp	\
 					src/gfx/GAction.cpp		\					
 					src/gfx/GSort.cpp		\					
 					src/gfx/PHScene.cpp		\
+					src/gfx/PHReplay.cpp	\
 					src/gviz/GVSkeletonGraph.cpp \
+					src/io/AnalysisJob.cpp	\
 					src/io/IO.cpp			\
+					src/io/ModelLoader.cpp	\
+					src/io/ModelValidator.cpp	\
+					src/io/PHCache.cpp		\
+					src/io/PHExpander.cpp	\
+					src/io/PHGenerator.cpp	\
 					src/io/PHIO.cpp			\
+					src/io/Trace.cpp		\
 					src/ph/Action.cpp		\
+					src/ph/Fixpoints.cpp	\
+					src/ph/LocalCausality.cpp	\
+					src/ph/ActionTable.cpp	\
 					src/ph/PH.cpp			\					
+					src/ph/PHDiff.cpp		\
 					src/ph/Process.cpp		\
+					src/ph/Reachability.cpp	\
 					src/ph/Sort.cpp			\
 					src/ui/MainWindow.cpp 	\
 					src/ui/MyArea.cpp \
     src/ui/TextArea.cpp \
     src/ui/TreeArea.cpp \
+    src/ui/JobsPanel.cpp \
+    src/ui/FixpointsModel.cpp \
     src/ui/Area.cpp \
     src/ui/ColorerSequences.cpp \
     src/ui/ConnectionSettings.cpp \
@@ -67,10 +97,28 @@ test {
 
 	QMAKE_CXXFLAGS += -ggdb
 	QT += testlib
-	HEADERS +=	headers/test/PHIOTest.h
+	HEADERS +=	headers/test/PHIOTest.h	\
+				headers/test/SyntheticDump.h
 	SOURCES	+= 	src/test/TestRunner.cpp	\
 				src/test/PHIOTest.cpp
 
+} else:cli {
+
+	# headless batch processing: qmake CONFIG+=cli
+	TARGET 	= pappl-cli
+	CONFIG 	+= console
+	SOURCES	+= src/Cli.cpp
+
+} else:bench {
+
+	# benchmarks: qmake CONFIG+=bench, then bin/pappl-bench -xml -o bench.xml for machine-readable results
+	TARGET 	= pappl-bench
+	QT += testlib
+	HEADERS +=	headers/test/PHBench.h	\
+				headers/test/SyntheticDump.h
+	SOURCES	+= 	src/test/BenchRunner.cpp	\
+				src/test/PHBench.cpp
+
 } else {
 
 	SOURCES	+= src/Main.cpp
@@ -0,0 +1,357 @@
+#include <QApplication>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+/*!
+ * @file Cli.cpp
+ * @author PGROU_2013
+ * @brief Command line program
+ * @details Validates, normalizes and exports PH files without the GUI, see usage()
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Exceptions.h"
+#include "Fixpoints.h"
+#include "LocalCausality.h"
+#include "PH.h"
+#include "PHGenerator.h"
+#include "PHIO.h"
+#include "Reachability.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+
+// a file to process, and what became of it
+struct Job {
+    QString path;
+    QString error;
+    PHPtr ph;
+    QList<GVNode> layout;
+};
+
+static string command;
+static QString outputDir;
+
+
+static int usage (void) {
+    cerr << "usage: pappl-cli [-j threads] [-o directory] command files or directories..." << endl
+         << "       pappl-cli generate [--option value]... [file]" << endl
+         << "       pappl-cli [-j threads] reach [--max-states N] [--explicit] file sort process [sort process]..." << endl
+         << "       pappl-cli [-j threads] fixpoints [--max N] file" << endl
+         << "commands:" << endl
+         << "  validate   parses each file (macros are expanded) and reports errors" << endl
+         << "  normalize  writes each file in basic form, as NAME.normalized.ph" << endl
+         << "  dot        writes the graph of each file, as NAME.dot" << endl
+         << "  png        lays out and renders each file, as NAME.png" << endl
+         << "  generate   writes a synthetic model to the file (or the standard output), options:" << endl
+         << "             --seed N, --sorts N, --processes N (per sort, at most), --density D (actions per sort)," << endl
+         << "             --regulators N (sorts hitting a sort), --topology scale-free|modular|layered," << endl
+         << "             --groups N (modules or layers), --macros F and --rates F (shares of regulations, in [0, 1])" << endl
+         << "  reach      tells whether the processes can be active together, starting from the initial state," << endl
+         << "             and writes a sequence of actions leading there; the model is analysed statically first" << endl
+         << "             (local causality), the states being explored only when that is not conclusive or with" << endl
+         << "             --explicit, which gives a shortest sequence;" << endl
+         << "             exits with 0 if they can, 1 if they cannot, 3 if too many states (4194304 by default)" << endl
+         << "  fixpoints  writes the states in which no action can be played, one a line (e.g. a 1 b 0);" << endl
+         << "             exits with 3 if there are too many (1048576 by default)" << endl
+         << "directories are searched recursively for .ph and .ph.gz files, which are processed in parallel;" << endl
+         << "compressed files stay compressed once normalized;" << endl
+         << "outputs go next to their file unless -o is given;" << endl
+         << "png uses the offscreen platform with Qt 5, Qt 4 needs an X display (e.g. xvfb-run)" << endl;
+    return 2;
+}
+
+
+// the .ph files given, directories being searched recursively
+static QStringList collectFiles (const QStringList& args) {
+    QStringList files;
+    for (const QString &arg : args) {
+        if (!QFileInfo(arg).isDir()) {
+            files << arg;
+            continue;
+        }
+        QStringList found;
+        QDirIterator it(arg, QStringList() << "*.ph" << "*.ph.gz", QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            found << it.next();
+        found.sort();
+        files << found;
+    }
+    return files;
+}
+
+
+// where to write an output of the file, NAME.ph.gz giving NAME.extension
+static QString outputPath (const QString& path, const QString& extension) {
+    QFileInfo info(path);
+    QString dir = outputDir.isEmpty() ? info.absolutePath() : outputDir;
+    QString name = info.fileName();
+    if (name.endsWith(".gz"))
+        name.chop(3);
+    return dir + "/" + QFileInfo(name).completeBaseName() + "." + extension;
+}
+
+
+// message for the user, with the location of the error when known
+static QString describe (exception_base& x) {
+    QString res;
+    if (const int* line = boost::get_error_info<line_info>(x))
+        res += "line " + QString::number(*line) + ": ";
+    if (const string* detail = boost::get_error_info<parse_info>(x))
+        res += QString::fromStdString(*detail);
+    else if (const string* sort = boost::get_error_info<sort_info>(x))
+        res += "unknown sort " + QString::fromStdString(*sort);
+    else if (const int* process = boost::get_error_info<process_info>(x))
+        res += "unknown process " + QString::number(*process);
+    else if (const string* file = boost::get_error_info<file_info>(x))
+        res += "cannot access " + QString::fromStdString(*file);
+    else
+        res += "cannot be parsed";
+    return res;
+}
+
+
+// pappl-cli generate [--option value]... [file]
+static int generate (const QStringList& args) {
+    PHGenerator::Options o;
+    QString path;
+    for (int i = 0; i < args.size(); i++) {
+        QString arg = args[i];
+        if (!arg.startsWith("--")) {
+            if (!path.isEmpty())
+                return usage();
+            path = arg;
+            continue;
+        }
+        if (i + 1 == args.size())
+            return usage();
+        string value = args[++i].toStdString();
+        bool ok = true;
+        if (arg == "--seed")                o.seed = args[i].toUInt(&ok);
+        else if (arg == "--sorts")          o.sorts = args[i].toInt(&ok);
+        else if (arg == "--processes")      o.processes = args[i].toInt(&ok);
+        else if (arg == "--density")        o.density = args[i].toDouble(&ok);
+        else if (arg == "--regulators")     o.regulators = args[i].toInt(&ok);
+        else if (arg == "--topology")       ok = PHGenerator::topologyFromName(value, o.topology);
+        else if (arg == "--groups")         o.groups = args[i].toInt(&ok);
+        else if (arg == "--macros")         o.macros = args[i].toDouble(&ok);
+        else if (arg == "--rates")          o.rates = args[i].toDouble(&ok);
+        else ok = false;
+        if (!ok) {
+            cerr << "invalid option " << arg.toStdString() << " " << value << endl;
+            return usage();
+        }
+    }
+
+    if (path.isEmpty()) {
+        PHGenerator::write(cout, o);
+        return 0;
+    }
+    std::ofstream output(path.toLocal8Bit().constData());
+    int actions = PHGenerator::write(output, o);
+    output.close();
+    if (!output) {
+        cerr << "cannot write " << path.toStdString() << endl;
+        return 1;
+    }
+    cout << actions << " actions and macros written to " << path.toStdString() << endl;
+    return 0;
+}
+
+
+// pappl-cli reach [--max-states N] [--explicit] file sort process [sort process]...
+static int reach (const QStringList& args, int threads) {
+    Reachability::Options o;
+    o.threads = threads;
+    bool explicitOnly = false;
+    QStringList rest = args;
+    while (!rest.isEmpty() && rest[0].startsWith("--")) {
+        if (rest[0] == "--explicit") {
+            explicitOnly = true;
+            rest = rest.mid(1);
+        } else if (rest.size() >= 2 && rest[0] == "--max-states") {
+            bool ok;
+            o.maxStates = rest[1].toULongLong(&ok);
+            if (!ok)
+                return usage();
+            rest = rest.mid(2);
+        } else
+            return usage();
+    }
+    if (rest.size() < 3)
+        return usage();
+
+    try {
+        PHPtr ph = PHIO::parseFile(rest[0].toStdString());
+        vector<Reachability::Requirement> goal = Reachability::parseGoal(*ph, rest.mid(1).join(" ").toStdString());
+        if (!explicitOnly) {
+            LocalCausality causality(*ph);
+            LocalCausality::Result c = causality.run(goal);
+            if (c.answer != Reachability::Unknown) {
+                cout << Reachability::answerName(c.answer) << " by local causality, " << c.elapsed / 1000.0 << " ms" << endl;
+                for (int a : c.witness)
+                    ph->getAction(a).write(cout);
+                return c.answer == Reachability::Reachable ? 0 : 1;
+            }
+            cerr << "local causality not conclusive, exploring the states" << endl;
+        }
+        Reachability engine(*ph);
+        Reachability::Result r = engine.run(goal, o, [] (int depth, size_t states) {
+            cerr << "depth " << depth << ", " << states << " states" << endl;
+        });
+        cout    << Reachability::answerName(r.answer) << ": " << r.states << " states, depth " << r.depth
+                << ", " << r.elapsed << " ms" << endl;
+        // a shortest path to the goal
+        for (int a : r.witness)
+            ph->getAction(a).write(cout);
+        return r.answer == Reachability::Reachable ? 0 : r.answer == Reachability::Unreachable ? 1 : 3;
+    } catch (exception_base& x) {
+        cerr << "error " << rest[0].toStdString() << ": " << describe(x).toStdString() << endl;
+        return 2;
+    }
+}
+
+
+// pappl-cli fixpoints [--max N] file
+static int fixpoints (const QStringList& args, int threads) {
+    Fixpoints::Options o;
+    o.threads = threads;
+    QStringList rest = args;
+    if (rest.size() >= 2 && rest[0] == "--max") {
+        bool ok;
+        o.maxFixpoints = rest[1].toULongLong(&ok);
+        if (!ok)
+            return usage();
+        rest = rest.mid(2);
+    }
+    if (rest.size() != 1)
+        return usage();
+
+    try {
+        PHPtr ph = PHIO::parseFile(rest[0].toStdString());
+        Fixpoints engine(*ph);
+        Fixpoints::Result r = engine.run([&ph] (const vector<Fixpoints::State>& found) {
+            for (const Fixpoints::State& state : found) {
+                for (int s = 0; s < (int) state.size(); s++)
+                    cout << (s > 0 ? " " : "") << ph->getSort(s)->getName() << " " << state[s];
+                cout << endl;
+            }
+        }, o);
+        cerr << r.fixpoints << " fixpoints, " << r.nodes << " choices, " << r.elapsed << " ms" << endl;
+        return r.complete ? 0 : 3;
+    } catch (exception_base& x) {
+        cerr << "error " << rest[0].toStdString() << ": " << describe(x).toStdString() << endl;
+        return 2;
+    }
+}
+
+
+// run by the worker threads: everything but drawing, which needs the GUI thread
+static void process (Job& job) {
+    try {
+        job.ph = PHIO::parseFile(job.path.toStdString());
+        if (command == "normalize")
+            PHIO::writeToFile(outputPath(job.path, job.path.endsWith(".gz") ? "normalized.ph.gz" : "normalized.ph").toStdString(), job.ph);
+        else if (command == "dot")
+            PHIO::writeDotToFile(outputPath(job.path, "dot").toStdString(), job.ph);
+        if (command == "png")
+            job.layout = job.ph->layoutSkeleton();
+        else
+            job.ph.reset();
+    } catch (exception_base& x) {
+        job.error = describe(x);
+        job.ph.reset();
+    } catch (std::exception& x) {
+        job.error = x.what();
+        job.ph.reset();
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+
+    // options, then the command and the files
+    int threads = 0;
+    QStringList args;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (arg == "-o" && i + 1 < argc)
+            outputDir = QString::fromLocal8Bit(argv[++i]);
+        else if (arg == "-h" || arg == "--help")
+            return usage();
+        else if (command.empty())
+            command = arg;
+        else
+            args << QString::fromLocal8Bit(argv[i]);
+    }
+    if (command == "generate")
+        return generate(args);
+    if (command == "reach") {
+        QCoreApplication app(argc, argv);
+        return reach(args, threads);
+    }
+    if (command == "fixpoints") {
+        QCoreApplication app(argc, argv);
+        return fixpoints(args, threads);
+    }
+    if (    (command != "validate" && command != "normalize" && command != "dot" && command != "png")
+        ||  args.isEmpty())
+        return usage();
+
+    // only rendering needs the GUI classes, without any window (offscreen platform when available)
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QScopedPointer<QCoreApplication> app(command == "png" ? new QApplication(argc, argv) : new QCoreApplication(argc, argv));
+
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        cerr << "cannot create " << outputDir.toStdString() << endl;
+        return 2;
+    }
+    if (threads > 0)
+        QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    // files are processed in parallel, then drawn one by one
+    QList<Job> jobs;
+    for (const QString &file : collectFiles(args)) {
+        Job job;
+        job.path = file;
+        jobs << job;
+    }
+    QtConcurrent::blockingMap(jobs, process);
+
+    int errors = 0;
+    for (Job &job : jobs) {
+        if (job.error.isEmpty() && command == "png") {
+            try {
+                job.ph->render(job.layout);
+                PHIO::exportToPNG(job.ph, outputPath(job.path, "png"));
+            } catch (exception_base& x) {
+                job.error = describe(x);
+            }
+        }
+        if (job.error.isEmpty()) {
+            cout << "ok " << job.path.toStdString() << endl;
+        } else {
+            cerr << "error " << job.path.toStdString() << ": " << job.error.toStdString() << endl;
+            errors++;
+        }
+        job.ph.reset();
+    }
+
+    cout << jobs.size() << " files, " << errors << " errors" << endl;
+    return errors == 0 ? 0 : 1;
+}
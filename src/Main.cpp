@@ -12,13 +12,27 @@
 #include <iostream>
 #include "IO.h"
 #include "PHIO.h"
+#include "Trace.h"
 
 int main(int argc, char *argv[]) {
 
     QApplication app(argc, argv);
+
+    // PAPPL_TRACE=file.json records the duration of each phase into file.json
+    QString trace = QProcessEnvironment::systemEnvironment().value("PAPPL_TRACE");
+    Trace::setEnabled(!trace.isEmpty());
+
     MainWindow window;
     window.show();
 
-    return app.exec();
+    // files given on the command line are opened at once
+    QStringList files = app.arguments().mid(1);
+    if (!files.isEmpty())
+        window.openFiles(files);
+
+    int res = app.exec();
+    if (!trace.isEmpty())
+        Trace::writeChromeTrace(trace);
+    return res;
 
 }
@@ -9,23 +9,13 @@
 #include <QtCore/qmath.h>
 
 
-GAction::GAction(ActionPtr a, PHScene* sc) : scene(sc), action(a) {
+GAction::GAction(int a, PHScene* sc) : scene(sc), action(a), highlighted(false) {
     display = new QGraphicsItemGroup();
 
     initContactPoints();
 
     hitLine= new QGraphicsPathItem(createHitPath(),display);
-    if((targetPoint->x()==resultPoint->x())&&(targetPoint->y()==resultPoint->y())) {
-	QPen pen;
-        pen.setWidth(2);
-        pen.setBrush(Qt::red);
-	hitLine->setPen(pen);
-    }else{
-        QPen pen;
-        pen.setWidth(1);
-	pen.setBrush(Qt::black);
-	hitLine->setPen(pen);
-    }
+    applyPen();
 
     boundArc = new QGraphicsPathItem(createBoundPath(),display);
     boundArc->setPen(QPen(Qt::DashLine));
@@ -38,21 +28,34 @@ void GAction::update() {
 
     boundArc->setPath(createBoundPath());
     hitLine->setPath(createHitPath());
-    if((targetPoint->x()==resultPoint->x())&&(targetPoint->y()==resultPoint->y())) {
-	QPen pen;
+    applyPen();
+
+}
+
+// red for actions which do not change the target, orange and thick when highlighted
+void GAction::applyPen() {
+    QPen pen;
+    if (highlighted) {
+        pen.setWidth(5);
+        pen.setBrush(QColor(255,140,0));
+    } else if((targetPoint->x()==resultPoint->x())&&(targetPoint->y()==resultPoint->y())) {
         pen.setWidth(2);
         pen.setBrush(Qt::red);
-	hitLine->setPen(pen);
     }else{
-        QPen pen;
         pen.setWidth(1);
         pen.setBrush(Qt::black);
-	hitLine->setPen(pen);
     }
+    hitLine->setPen(pen);
+}
 
+void GAction::setHighlighted(bool on) {
+    if (on == highlighted)
+        return;
+    highlighted = on;
+    applyPen();
 }
 
-GAction::GAction(){
+GAction::GAction() : highlighted(false) {
 }
 
 // Important for the destructor : do not delete scene, it's owned by a shared pointer in PH.h
@@ -61,8 +64,8 @@ GAction::~GAction() {
 }
 
 void GAction::initContactPoints(){
-    GSortPtr sourceSort = scene->getGSort(action->getSource()->getSort()->getName());
-    GSortPtr targetSort = scene->getGSort(action->getTarget()->getSort()->getName());
+    GSortPtr sourceSort = scene->getGSort(getAction().getSource()->getSort()->getId());
+    GSortPtr targetSort = scene->getGSort(getAction().getTarget()->getSort()->getId());
 
     if(sourceSort->getSimpleDisplay()!=1||targetSort->getSimpleDisplay()!=1){
 	initPointsInDetailledModel();
@@ -73,8 +76,8 @@ void GAction::initContactPoints(){
 
 void GAction::updateContactPoints(){
 
-    GSortPtr sourceSort = scene->getGSort(action->getSource()->getSort()->getName());
-    GSortPtr targetSort = scene->getGSort(action->getTarget()->getSort()->getName());
+    GSortPtr sourceSort = scene->getGSort(getAction().getSource()->getSort()->getId());
+    GSortPtr targetSort = scene->getGSort(getAction().getTarget()->getSort()->getId());
 
     if(sourceSort->getSimpleDisplay()!=1||targetSort->getSimpleDisplay()!=1){
 	updatePointsInDetailledModel();
@@ -84,8 +87,8 @@ void GAction::updateContactPoints(){
 }
 
 void GAction::initPointsInSimpleModele(){
-    	GSortPtr sourceSort = scene->getGSort(action->getSource()->getSort()->getName());
-    	GSortPtr targetSort = scene->getGSort(action->getTarget()->getSort()->getName());
+    	GSortPtr sourceSort = scene->getGSort(getAction().getSource()->getSort()->getId());
+    	GSortPtr targetSort = scene->getGSort(getAction().getTarget()->getSort()->getId());
 
 	sourcePoint = new QPointF(sourceSort->getCenterPoint());	
 	targetPoint = new QPointF(targetSort->getCenterPoint());
@@ -98,8 +101,8 @@ void GAction::initPointsInDetailledModel(){
 
 void GAction::updatePointsInSimpleModel(){
 
-    	GSortPtr sourceSort = scene->getGSort(action->getSource()->getSort()->getName());
-    	GSortPtr targetSort = scene->getGSort(action->getTarget()->getSort()->getName());
+    	GSortPtr sourceSort = scene->getGSort(getAction().getSource()->getSort()->getId());
+    	GSortPtr targetSort = scene->getGSort(getAction().getTarget()->getSort()->getId());
 
 	sourcePoint->setX(sourceSort->getCenterPoint().x());
 	sourcePoint->setY(sourceSort->getCenterPoint().y());	
@@ -328,18 +331,22 @@ QGraphicsItem* GAction::getDisplayItem (void) {
     return display;
 }
 
-ActionPtr GAction::getAction() {
-    return action;
+Action GAction::getAction() {
+    return scene->getPH()->getAction(action);
+}
+
+void GAction::setIndex(int a) {
+    action = a;
 }
 
 GProcessPtr GAction::getSource() {
-    return action->getSource()->getGProcess();
+    return getAction().getSource()->getGProcess();
 }
 
 GProcessPtr GAction::getTarget() {
-    return action->getTarget()->getGProcess();
+    return getAction().getTarget()->getGProcess();
 }
 
 GProcessPtr GAction::getResult() {
-    return action->getResult()->getGProcess();
+    return getAction().getResult()->getGProcess();
 }
@@ -13,7 +13,7 @@ const int GProcess::marginZone  = 10;
 const int GProcess::sortName    = 11;
 const int GProcess::sizeDefault = 100;
 
-GProcess::GProcess(ProcessPtr p,double centerX, double centerY) : process(p){
+GProcess::GProcess(ProcessPtr p,double centerX, double centerY) : process(p), highlighted(false){
 
 	display = new QGraphicsItemGroup();
 
@@ -36,6 +36,20 @@ GProcess::~GProcess() {
 }
 
 
+// the brush of the ellipse is kept, since it depends on the style chosen
+void GProcess::setHighlighted(bool on) {
+    if (on == highlighted)
+        return;
+    highlighted = on;
+    if (on) {
+        brush = ellipse->brush();
+        ellipse->setBrush(QBrush(QColor(255,200,0)));
+    } else {
+        ellipse->setBrush(brush);
+    }
+}
+
+
 // Init methods
 
 void GProcess::initGeometricsValues(QPointF centerPoint, double diameter){
@@ -80,6 +94,8 @@ void GProcess::initTextItem(){
 
 ProcessPtr* GProcess::getProcess() { return &(this->process); }
 
+void GProcess::setProcess(ProcessPtr p) { process = p; }
+
 QGraphicsItem* GProcess::getDisplayItem (void) { return display; }
 
 QGraphicsEllipseItem* GProcess::getEllipseItem(){ return ellipse; }
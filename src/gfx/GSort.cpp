@@ -71,10 +71,10 @@ void GSort::initTextItem(){
 }
 
 void GSort::initGProcessChildren(){
-    vector<ProcessPtr> processes = sort->getProcesses();
+    const vector<ProcessPtr>& processes = sort->getProcesses();
     int currPosYProcess = marginDefault+GProcess::sizeDefault/2;
 
-    for(ProcessPtr &p : processes){
+    for(const ProcessPtr &p : processes){
 	gProcesses.push_back(make_shared<GProcess>(p,leftTopCorner->x() + GProcess::sizeDefault/2+ marginDefault, leftTopCorner->y()+ currPosYProcess));
 	currPosYProcess+= 2*marginDefault + GProcess::sizeDefault;
     }
@@ -177,6 +177,15 @@ QGraphicsRectItem* GSort::getRect() { return this->_rect; }
 
 SortPtr GSort::getSort() { return this->sort; }
 
+void GSort::setSort(SortPtr s) {
+    sort = s;
+    const vector<ProcessPtr>& processes = sort->getProcesses();
+    for (size_t i = 0; i < gProcesses.size() && i < processes.size(); i++) {
+        gProcesses[i]->setProcess(processes[i]);
+        processes[i]->setGProcess(gProcesses[i]);
+    }
+}
+
 GVNode GSort::getNode() { return this->node; }
 
 QGraphicsTextItem* GSort::getText() { return this->text; }
@@ -233,11 +242,11 @@ void GSort::cancelShift(){
 }
 
 bool GSort::isOverAnotherGSort(){
-    map<string, GSortPtr> listGSorts = dynamic_cast<PHScene*>(scene())->getGSorts();
+    const map<string, GSortPtr>& listGSorts = dynamic_cast<PHScene*>(scene())->getGSorts();
     bool resetPosition = false;
 
     for(auto &s : listGSorts){
-       if(s.second.get()->getSort()->getName()!=sort->getName()){
+       if(s.second.get()->getSort()->getId()!=sort->getId()){
 	   if(isOver(s.second.get())){
 		resetPosition = true;
 	   }
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <sstream>
+#include "GAction.h"
+#include "GProcess.h"
+#include "PHReplay.h"
+
+
+PHReplay::PHReplay (PHPtr _ph, const vector<int>& _actions, const vector<int>& initial) : ph(_ph), actions(_actions), step(0) {
+
+    for (int a : actions) {
+        Action action = ph->getAction(a);
+        sorts.push_back(action.getTarget()->getSort()->getId());
+        before.push_back(action.getTarget()->getNumber());
+        after.push_back(action.getResult()->getNumber());
+    }
+
+    // the initial state: every sort is highlighted once, then only the ones which change
+    for (int s = 0; s < ph->countSorts(); s++) {
+        active.push_back(initial.empty() ? ph->getSort(s)->getActiveProcess()->getNumber() : initial[s]);
+        highlightProcess(s, true);
+    }
+    highlightAction(0, true);
+}
+
+PHReplay::~PHReplay () {
+    highlightAction(step, false);
+    for (int s = 0; s < ph->countSorts(); s++)
+        highlightProcess(s, false);
+}
+
+
+int PHReplay::countSteps (void) { return actions.size(); }
+int PHReplay::getStep (void) { return step; }
+PHPtr PHReplay::getPH (void) { return ph; }
+
+
+void PHReplay::setStep (int target) {
+    target = std::max(0, std::min(target, countSteps()));
+    if (target == step)
+        return;
+    highlightAction(step, false);
+
+    // actions played forwards, or undone backwards
+    while (step < target) {
+        highlightProcess(sorts[step], false);
+        active[sorts[step]] = after[step];
+        highlightProcess(sorts[step], true);
+        step++;
+    }
+    while (step > target) {
+        step--;
+        highlightProcess(sorts[step], false);
+        active[sorts[step]] = before[step];
+        highlightProcess(sorts[step], true);
+    }
+
+    highlightAction(step, true);
+}
+
+
+string PHReplay::describe (int step) {
+    if (step < 0 || step >= countSteps())
+        return "";
+    std::ostringstream res;
+    Action a = ph->getAction(actions[step]);
+    res     << a.getSource()->getSort()->getName() << " " << a.getSource()->getNumber() << " -> "
+            << a.getTarget()->getSort()->getName() << " " << a.getTarget()->getNumber() << " " << a.getResult()->getNumber();
+    return res.str();
+}
+
+
+void PHReplay::highlightProcess (int sort, bool on) {
+    ph->getSort(sort)->getProcess(active[sort])->getGProcess()->setHighlighted(on);
+}
+
+void PHReplay::highlightAction (int step, bool on) {
+    if (step < countSteps())
+        ph->getGraphicsScene()->getAction(actions[step])->setHighlighted(on);
+}
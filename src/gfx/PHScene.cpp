@@ -4,10 +4,14 @@
 #include <QColor>
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/lexical_cast.hpp>
 #include "Exceptions.h"
 #include "PH.h"
+#include "PHDiff.h"
 #include "PHScene.h"
+#include "Trace.h"
 #include <map>
+#include <QHash>
 #include <QDebug>
 
 PHScene::PHScene(PH* _ph) : ph(_ph) {
@@ -17,18 +21,28 @@ PHScene::PHScene(PH* _ph) : ph(_ph) {
 
 
 void PHScene::drawFromSkeleton(void){
-	GVSkeletonGraphPtr gSkeleton = ph->createSkeletonGraph();
-	
-	QList<GVNode> gSkeletonNodes = gSkeleton->nodes();
-	for(GVNode &gn : gSkeletonNodes){
-		for(SortPtr &s : ph->getSorts()){
-			int nbProcess = (s->getProcesses()).size();
-			int width = GProcess::sizeDefault+2*GSort::marginDefault;
-			int height = nbProcess*(GProcess::sizeDefault+2*GSort::marginDefault);
-			if(gn.name == makeSkeletonNodeName(s->getName())){
-                sorts.insert(GSortEntry(s->getName(), make_shared<GSort>(s,gn,width,height)));
-			}
-		}	
+	drawFromSkeleton(ph->layoutSkeleton());
+}
+
+void PHScene::drawFromSkeleton(const QList<GVNode>& gSkeletonNodes){
+	TRACE_SCOPE("draw scene");
+	sortsById.resize(ph->countSorts());
+
+	// match nodes and sorts by name, going through each of them once
+	QHash<QString, SortPtr> sortsByNode;
+	sortsByNode.reserve(ph->countSorts());
+	for(SortPtr &s : ph->getSorts()){
+		sortsByNode.insert(makeSkeletonNodeName(s->getName()), s);
+	}
+	for(const GVNode &gn : gSkeletonNodes){
+		QHash<QString, SortPtr>::iterator f = sortsByNode.find(gn.name);
+		if(f == sortsByNode.end()){
+			continue;
+		}
+		SortPtr s = f.value();
+		GSortPtr gs = makeGSort(s, gn);
+		sorts.insert(GSortEntry(s->getName(), gs));
+		sortsById[s->getId()] = gs;
 	}
 	// Clear the scene and add sorts item (containing also processes) to the scene
 	clear();
@@ -44,6 +58,87 @@ void PHScene::drawFromSkeleton(void){
 }
 
 
+GSortPtr PHScene::makeGSort(SortPtr s, const GVNode& node){
+	int nbProcess = s->countProcesses();
+	int width = GProcess::sizeDefault+2*GSort::marginDefault;
+	int height = nbProcess*(GProcess::sizeDefault+2*GSort::marginDefault);
+	return make_shared<GSort>(s,node,width,height);
+}
+
+
+void PHScene::patch(PH* _ph, const PHDiff& diff, const QList<GVNode>& gSkeletonNodes){
+	TRACE_SCOPE("patch scene");
+	ph = _ph;
+
+	// removed and resized sorts are dropped, their processes letting go of their GProcess first
+	// (the GSort deletes the items of its children)
+	map<string, GVNode> resized;
+	for (const string &name : diff.resizedSorts) {
+		GVNode node = sorts[name]->getNode();
+		node.centerPos = sorts[name]->getCenterPoint().toPoint();
+		resized[name] = node;
+	}
+	vector<string> dropped(diff.removedSorts);
+	dropped.insert(dropped.end(), diff.resizedSorts.begin(), diff.resizedSorts.end());
+	for (const string &name : dropped) {
+		map<string, GSortPtr>::iterator f = sorts.find(name);
+		if (f == sorts.end())
+			continue;
+		for (const ProcessPtr &p : f->second->getSort()->getProcesses())
+			p->setGProcess(GProcessPtr());
+		sorts.erase(f);
+	}
+
+	// kept sorts are bound to the new version, the others are drawn
+	QHash<QString, GVNode> nodes;
+	for (const GVNode &gn : gSkeletonNodes)
+		nodes.insert(gn.name, gn);
+	sortsById.assign(ph->countSorts(), GSortPtr());
+	vector<bool> redrawn(ph->countSorts(), false);
+	for (SortPtr &s : ph->getSorts()) {
+		GSortPtr gs;
+		map<string, GSortPtr>::iterator f = sorts.find(s->getName());
+		if (f != sorts.end()) {
+			gs = f->second;
+			gs->setSort(s);
+		} else {
+			map<string, GVNode>::iterator r = resized.find(s->getName());
+			QHash<QString, GVNode>::iterator n = nodes.find(makeSkeletonNodeName(s->getName()));
+			if (r != resized.end())
+				gs = makeGSort(s, r->second);
+			else if (n != nodes.end())
+				gs = makeGSort(s, n.value());
+			else
+				continue;
+			sorts.insert(GSortEntry(s->getName(), gs));
+			addItem(gs.get());
+			redrawn[s->getId()] = true;
+		}
+		sortsById[s->getId()] = gs;
+	}
+
+	// kept actions between kept sorts move to their new index, the others are drawn
+	TRACE_SCOPE("patch actions");
+	vector<GActionPtr> previous;
+	previous.swap(actions);
+	actions.reserve(ph->countActions());
+	const ActionTable& table = ph->getActionTable();
+	for (int i = 0; i < ph->countActions(); i++) {
+		int p = diff.previousActions[i];
+		int source = ph->getProcess(table.getSources()[i])->getSort()->getId();
+		int target = ph->getProcess(table.getTargets()[i])->getSort()->getId();
+		if (p >= 0 && !redrawn[source] && !redrawn[target]) {
+			actions.push_back(previous[p]);
+			actions.back()->setIndex(i);
+			previous[p].reset();
+		} else {
+			actions.push_back(make_shared<GAction>(i,this));
+			addItem(actions.back()->getDisplayItem());
+		}
+	}
+}
+
+
 // retrieve GSort by its related Sort's name
 GSortPtr PHScene::getGSort (const string& s) {
     map<string, GSortPtr>::iterator f = sorts.find(s);
@@ -52,12 +147,24 @@ GSortPtr PHScene::getGSort (const string& s) {
 	return sorts[s];
 }
 
+// retrieve GSort by its related Sort's identifier
+GSortPtr PHScene::getGSort (int id) {
+    if (id < 0 || id >= (int) sortsById.size() || !sortsById[id])
+        throw sort_not_found() << sort_info(boost::lexical_cast<string>(id));
+    return sortsById[id];
+}
+
+// get the related process hitting
+PH* PHScene::getPH(){
+    return ph;
+}
+
 // get all the GSort
-map<string, GSortPtr> PHScene::getGSorts(){
+const map<string, GSortPtr>& PHScene::getGSorts(){
     return this->sorts;
 }
 
-std::vector<GProcessPtr> PHScene::getProcesses(){
+const std::vector<GProcessPtr>& PHScene::getProcesses(){
     return processes;
 }
 
@@ -65,6 +172,10 @@ std::vector<GActionPtr> PHScene::getActions(){
     return actions;
 }
 
+GActionPtr PHScene::getAction(int index){
+    return actions[index];
+}
+
 void PHScene::updateActions(){
     for(auto &a: actions){
         a->update();
@@ -72,9 +183,11 @@ void PHScene::updateActions(){
 }
 
 void PHScene::createActions() {
+    TRACE_SCOPE("create actions");
     // create GAction items
-    for (ActionPtr &a : ph->getActions()) {
-    	actions.push_back(make_shared<GAction>(a,this));
+    actions.reserve(ph->countActions());
+    for (int i = 0; i < ph->countActions(); i++) {
+    	actions.push_back(make_shared<GAction>(i,this));
     }
 }
 
@@ -5,6 +5,7 @@
 #include <QRectF>
 #include "Exceptions.h"
 #include "GVSkeletonGraph.h"
+#include "Trace.h"
 #include "locale.h"
 
 const qreal GVSkeletonGraph::DotDefaultDPI=72.0;
@@ -89,6 +90,7 @@ void GVSkeletonGraph::setFont(QFont font){
 }
 
 void GVSkeletonGraph::applyLayout(){
+	TRACE_SCOPE("graphviz layout");
     	setlocale(LC_NUMERIC,"en_US.UTF-8");
 
 	gvFreeLayout(_context, _graph);
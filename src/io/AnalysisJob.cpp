@@ -0,0 +1,184 @@
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include "AnalysisJob.h"
+#include "Trace.h"
+
+
+// time given to the program to stop after cancel(), before it is killed
+static const int killDelay = 3000;
+
+
+// the job given to the pool for a task
+class AnalysisJobTask : public QRunnable {
+
+    public:
+        AnalysisJobTask (AnalysisJob* job_) : job(job_) {}
+
+        void run () {
+            int exitCode = 1;
+            try {
+                exitCode = job->task(*job);
+            } catch (std::exception& x) {
+                job->write(QString(x.what()) + "\n", true);
+            }
+            emit job->taskFinished(exitCode);
+            job->stopped.release();
+        }
+
+    private:
+        AnalysisJob* job;
+};
+
+
+AnalysisJob::AnalysisJob (const QString& name, Task task_, const QString& model_, QObject* parent)
+    : QObject(parent), program(name), model(model_), state(Starting), exitCode(0)
+    , startTime(Trace::now()), elapsed(-1), task(task_), working(false), cancelRequested(0) {
+    // queued, since the signal is emitted by the worker thread
+    connect(this, SIGNAL(taskFinished(int)), this, SLOT(taskDone(int)), Qt::QueuedConnection);
+}
+
+AnalysisJob::AnalysisJob (const QString& program_, const QStringList& arguments_, const QString& model_, QObject* parent)
+    : QObject(parent), program(program_), arguments(arguments_), model(model_), state(Starting), exitCode(0)
+    , startTime(Trace::now()), elapsed(-1), working(false), cancelRequested(0) {
+    killTimer.setSingleShot(true);
+    killTimer.setInterval(killDelay);
+    connect(&process, SIGNAL(started()), this, SLOT(started()));
+    connect(&process, SIGNAL(readyReadStandardOutput()), this, SLOT(readOutput()));
+    connect(&process, SIGNAL(readyReadStandardError()), this, SLOT(readError()));
+    connect(&process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(finished(int, QProcess::ExitStatus)));
+    connect(&process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(error(QProcess::ProcessError)));
+    connect(&killTimer, SIGNAL(timeout()), this, SLOT(kill()));
+}
+
+AnalysisJob::~AnalysisJob () {
+    if (working) {
+        cancelRequested.fetchAndStoreOrdered(1);
+        stopped.acquire();
+    }
+    if (process.state() != QProcess::NotRunning) {
+        process.disconnect(this);
+        process.kill();
+        process.waitForFinished(1000);
+    }
+}
+
+
+void AnalysisJob::start (void) {
+    startTime = Trace::now();
+    if (task) {
+        working = true;
+        setState(Running);
+        QThreadPool::globalInstance()->start(new AnalysisJobTask(this));
+    } else {
+        process.start(program, arguments);
+    }
+}
+
+void AnalysisJob::cancel (void) {
+    if (!isRunning())
+        return;
+    setState(Cancelled);
+    if (task) {
+        cancelRequested.fetchAndStoreOrdered(1);
+    } else {
+        process.terminate();
+        killTimer.start();
+    }
+}
+
+bool AnalysisJob::isCancelRequested (void) { return cancelRequested == 1; }
+
+
+void AnalysisJob::write (const QString& s, bool error) {
+    {
+        QMutexLocker lock(&textMutex);
+        text += s;
+    }
+    // queued to the receivers when called by the worker thread
+    emit output(s, error);
+}
+
+void AnalysisJob::taskDone (int exitCode_) {
+    stopped.acquire();
+    working = false;
+    finished(exitCode_, QProcess::NormalExit);
+}
+
+void AnalysisJob::kill (void) {
+    process.kill();
+}
+
+
+// QProcess signals
+
+void AnalysisJob::started (void) {
+    if (state == Starting)
+        setState(Running);
+}
+
+void AnalysisJob::readOutput (void) {
+    write(QString::fromLocal8Bit(process.readAllStandardOutput()));
+}
+
+void AnalysisJob::readError (void) {
+    write(QString::fromLocal8Bit(process.readAllStandardError()), true);
+}
+
+void AnalysisJob::finished (int exitCode_, QProcess::ExitStatus exitStatus) {
+    killTimer.stop();
+    exitCode = exitCode_;
+    if (state == Cancelled)
+        setState(Cancelled);
+    else
+        setState((exitStatus == QProcess::NormalExit && exitCode == 0) ? Finished : Failed);
+}
+
+void AnalysisJob::error (QProcess::ProcessError e) {
+    // other errors are followed by finished()
+    if (e != QProcess::FailedToStart)
+        return;
+    write(program + " could not be started, is it installed?\n", true);
+    setState(Failed);
+}
+
+
+void AnalysisJob::setState (State s) {
+    if (s != Starting && s != Running && elapsed < 0) {
+        elapsed = (Trace::now() - startTime) / 1000;
+        Trace::record("analysis", startTime, (program + " " + model).toStdString());
+    }
+    state = s;
+    emit stateChanged();
+
+    // once
+    if (!isRunning() && callback) {
+        Callback c = callback;
+        callback = Callback();
+        c(*this);
+    }
+}
+
+void AnalysisJob::setCallback (Callback c) { callback = c; }
+
+
+// getters
+QString AnalysisJob::getProgram (void) { return program; }
+QStringList AnalysisJob::getArguments (void) { return arguments; }
+QString AnalysisJob::getModel (void) { return model; }
+AnalysisJob::State AnalysisJob::getState (void) { return state; }
+QString AnalysisJob::getOutput (void) { QMutexLocker lock(&textMutex); return text; }
+int AnalysisJob::getExitCode (void) { return exitCode; }
+qint64 AnalysisJob::getElapsed (void) { return elapsed < 0 ? (Trace::now() - startTime) / 1000 : elapsed; }
+bool AnalysisJob::isRunning (void) { return state == Starting || state == Running || working || process.state() != QProcess::NotRunning; }
+
+QString AnalysisJob::stateName (State state) {
+    switch (state) {
+        case Starting:  return "Starting";
+        case Running:   return "Running";
+        case Finished:  return "Finished";
+        case Failed:    return "Failed";
+        case Cancelled: return "Cancelled";
+        default:        return "";
+    }
+}
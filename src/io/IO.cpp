@@ -1,7 +1,11 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <streambuf>
 #include <boost/filesystem.hpp>
 #include <QFile>
 #include <QString>
-#include <QTextStream>
+#include <zlib.h>
 #include "Exceptions.h"
 #include "IO.h"
 
@@ -12,13 +16,21 @@ string IO::readFile (string const& path) {
 	using namespace boost::filesystem;
 	IO::fileLocationCheck(path);
 	
-    // open text file in read only mode
+    // open file in read only mode, bytes are kept as is (no decoding)
 	QFile file(QString::fromUtf8(path.c_str()));
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	if (!file.open(QIODevice::ReadOnly))
 		throw io_error() << file_info(path);
-	QTextStream in(&file);
+	QByteArray content = file.readAll();
 	
-	return in.readAll().toStdString();
+	if (isCompressed(content.constData(), content.size())) {
+		try {
+			return decompress(content.constData(), content.size());
+		} catch (io_error& x) {
+			x << file_info(path);
+			throw;
+		}
+	}
+	return string(content.constData(), content.size());
 	
 }
 
@@ -39,15 +51,127 @@ void IO::fileLocationCheck (string const& path) {
 
 // write string as file (which path is given as parameter)
 void IO::writeFile (string const& path, string const& content) {
+	writeStream(path, [&] (std::ostream& out) { out.write(content.data(), content.size()); });
+}
 
-    // open text file in write only mode
-	QFile file(QString::fromUtf8(path.c_str()));
-    file.open(QIODevice::WriteOnly | QIODevice::Text);
 
-    // write string
-    QTextStream out(&file);
-    out << QString::fromUtf8(content.c_str());
+// output stream buffer compressing what it is given into a .gz file
+class GzipBuffer : public std::streambuf {
 
-    file.close();
-	
+	public:
+		GzipBuffer (gzFile file_) : file(file_), failed(false) {
+			setp(buffer, buffer + sizeof(buffer));
+		}
+
+		bool hasFailed (void) { return failed; }
+
+	protected:
+		int overflow (int c) {
+			if (sync() != 0)
+				return traits_type::eof();
+			if (c != traits_type::eof()) {
+				*pptr() = c;
+				pbump(1);
+			}
+			return traits_type::not_eof(c);
+		}
+
+		int sync (void) {
+			int length = pptr() - pbase();
+			if (length > 0 && gzwrite(file, pbase(), length) != length)
+				failed = true;
+			setp(buffer, buffer + sizeof(buffer));
+			return failed ? -1 : 0;
+		}
+
+	private:
+		gzFile file;
+		bool failed;
+		char buffer[1 << 16];
+};
+
+
+// stream the writer output to the file, through gzip for .gz files
+void IO::writeStream (string const& path, const std::function<void (std::ostream&)>& writer) {
+
+	bool compressed = path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+	bool failed;
+
+	if (compressed) {
+		gzFile file = gzopen(path.c_str(), "wb");
+		if (file == NULL)
+			throw io_error() << file_info(path);
+		GzipBuffer buffer(file);
+		std::ostream out(&buffer);
+		writer(out);
+		out.flush();
+		failed = !out || buffer.hasFailed();
+		failed = gzclose(file) != Z_OK || failed;
+	} else {
+		std::ofstream out(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (out)
+			writer(out);
+		out.close();
+		failed = !out;
+	}
+
+	if (failed)
+		throw io_error() << file_info(path);
+}
+
+
+// gzip magic number
+bool IO::isCompressed (const char* content, size_t length) {
+	return length >= 2 && (unsigned char) content[0] == 0x1f && (unsigned char) content[1] == 0x8b;
+}
+
+
+// inflate the whole content, which may be made of several gzip members (as cat a.gz b.gz)
+string IO::decompress (const char* content, size_t length) {
+
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+		throw io_error();
+
+	string res;
+	char buffer[1 << 16];
+	stream.next_in = (Bytef*) content;
+	int status = Z_OK;
+
+	while (status == Z_OK) {
+
+		// input is given by chunks, avail_in being 32 bits
+		if (stream.avail_in == 0) {
+			if (length == 0)
+				break;
+			stream.avail_in = length > (1u << 30) ? (1u << 30) : (uInt) length;
+			length -= stream.avail_in;
+		}
+
+		stream.next_out = (Bytef*) buffer;
+		stream.avail_out = sizeof(buffer);
+		status = inflate(&stream, Z_NO_FLUSH);
+		res.append(buffer, sizeof(buffer) - stream.avail_out);
+
+		// another member follows
+		if (status == Z_STREAM_END && (stream.avail_in > 0 || length > 0))
+			status = inflateReset(&stream);
+	}
+
+	// truncated or corrupted
+	inflateEnd(&stream);
+	if (status != Z_STREAM_END)
+		throw io_error();
+	return res;
+}
+
+
+// %g without the temporary strings of lexical_cast, same digits
+void IO::writeDecimal (std::ostream& out, double value, int digits) {
+	char buffer[32];
+	int length = snprintf(buffer, sizeof(buffer), "%.*g", digits, value);
+	out.write(buffer, length);
+	if (strspn(buffer, "-0123456789") == (size_t) length)
+		out.put('.');
 }
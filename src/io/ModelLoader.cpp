@@ -0,0 +1,139 @@
+#include <string>
+#include <QRunnable>
+#include <QThread>
+#include "Exceptions.h"
+#include "IO.h"
+#include "ModelLoader.h"
+#include "PHIO.h"
+#include "Trace.h"
+
+
+using std::string;
+
+
+// the job given to the pool
+class ModelLoaderTask : public QRunnable {
+
+    public:
+        ModelLoaderTask (ModelLoader* loader_) : loader(loader_) {}
+
+        void run () {
+            loader->run();
+            emit loader->workerFinished();
+            loader->stopped.release();
+        }
+
+    private:
+        ModelLoader* loader;
+};
+
+
+ModelLoader::ModelLoader (const QString& path_, QObject* parent) : QObject(parent), path(path_), cancelRequested(0), started(false) {
+    // queued, since the signal is emitted by the worker thread
+    connect(this, SIGNAL(workerFinished()), this, SLOT(workerDone()), Qt::QueuedConnection);
+}
+
+ModelLoader::~ModelLoader () {
+    if (started)
+        stopped.acquire();
+}
+
+
+// message for the user, with the location of the error when known
+static QString describe (exception_base& x) {
+    QString res = "This file could not be loaded";
+    if (const int* line = boost::get_error_info<line_info>(x))
+        res += " (line " + QString::number(*line) + ")";
+    res += ".";
+    if (const string* detail = boost::get_error_info<parse_info>(x))
+        res += "\n" + QString::fromStdString(*detail);
+    if (const string* sort = boost::get_error_info<sort_info>(x))
+        res += "\nUnknown sort: " + QString::fromStdString(*sort);
+    return res;
+}
+
+
+// run the stages in a worker thread
+void ModelLoader::start (void) {
+    startTime = Trace::now();
+    started = true;
+    pool()->start(new ModelLoaderTask(this));
+}
+
+QThreadPool* ModelLoader::pool (void) {
+    static QThreadPool* threads = NULL;
+    if (threads == NULL) {
+        threads = new QThreadPool();
+        threads->setMaxThreadCount(QThread::idealThreadCount());
+    }
+    return threads;
+}
+
+void ModelLoader::run (void) {
+
+    try {
+        // content (decompressed), for the text area and the parser
+        emit progress(Reading);
+        Trace::Scope reading("read", path.toStdString());
+        string content = IO::readFile(path.toStdString());
+        text = QString::fromUtf8(content.data(), content.size());
+        reading.stop();
+        if (isCancelled())
+            return;
+
+        // model (macros expanded, or loaded from the cache), from the content already read
+        emit progress(Parsing);
+        {
+            TRACE_SCOPE("parse file", path.toStdString());
+            ph = PHIO::parseCachedContent(content.data(), content.size(), path.toStdString(), true);
+        }
+        if (isCancelled())
+            return;
+
+        // graphviz layout (one file at a time), the scene itself is drawn by the GUI thread
+        emit progress(Layout);
+        layout = ph->layoutSkeleton();
+
+    } catch (exception_base& x) {
+        error = describe(x);
+    } catch (std::exception& x) {
+        error = x.what();
+    }
+}
+
+
+// back in the GUI thread
+void ModelLoader::workerDone (void) {
+    if (isCancelled()) {
+        ph.reset();
+        layout.clear();
+        emit cancelled();
+    } else if (!error.isEmpty()) {
+        emit failed(error);
+    } else {
+        emit progress(Drawing);
+        emit finished();
+    }
+}
+
+
+void ModelLoader::cancel (void) { cancelRequested.fetchAndStoreOrdered(1); }
+bool ModelLoader::isCancelled (void) { return cancelRequested == 1; }
+
+
+// getters
+QString ModelLoader::getPath (void) { return path; }
+QString ModelLoader::getText (void) { return text; }
+PHPtr ModelLoader::getPH (void) { return ph; }
+QList<GVNode> ModelLoader::getLayout (void) { return layout; }
+qint64 ModelLoader::getStartTime (void) { return startTime; }
+
+QString ModelLoader::stageName (int stage) {
+    switch (stage) {
+        case Reading:   return "Reading file";
+        case Parsing:   return "Parsing and expanding macros";
+        case Layout:    return "Computing the layout";
+        case Drawing:   return "Drawing the scene";
+        default:        return "Done";
+    }
+}
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <string>
+#include <QRunnable>
+#include <QThreadPool>
+#include "Exceptions.h"
+#include "ModelValidator.h"
+#include "PHIO.h"
+#include "Trace.h"
+
+
+using std::string;
+
+
+// the job given to the pool
+class ModelValidatorTask : public QRunnable {
+
+    public:
+        ModelValidatorTask (ModelValidator* validator_) : validator(validator_) {}
+
+        void run () {
+            validator->result = ModelValidator::check(validator->input);
+            emit validator->workerFinished();
+            validator->stopped.release();
+        }
+
+    private:
+        ModelValidator* validator;
+};
+
+
+ModelValidator::ModelValidator (int delay, QObject* parent) : QObject(parent), revision(0), inputRevision(0), busy(false) {
+    timer.setSingleShot(true);
+    timer.setInterval(delay);
+    connect(&timer, SIGNAL(timeout()), this, SLOT(startWorker()));
+    // queued, since the signal is emitted by the worker thread
+    connect(this, SIGNAL(workerFinished()), this, SLOT(workerDone()), Qt::QueuedConnection);
+}
+
+ModelValidator::~ModelValidator () {
+    if (busy)
+        stopped.acquire();
+}
+
+
+void ModelValidator::setText (const QString& text_) {
+    text = text_.toUtf8();
+    revision++;
+    timer.start();
+}
+
+
+void ModelValidator::startWorker (void) {
+    // the worker will start again once done
+    if (busy)
+        return;
+    busy = true;
+    input = text;
+    inputRevision = revision;
+    QThreadPool::globalInstance()->start(new ModelValidatorTask(this));
+}
+
+
+// back in the GUI thread
+void ModelValidator::workerDone (void) {
+    stopped.acquire();
+    busy = false;
+    input.clear();
+
+    // the text changed meanwhile: the result is out of date
+    if (inputRevision != revision) {
+        if (!timer.isActive())
+            startWorker();
+        return;
+    }
+
+    diagnostics = result;
+    emit validated();
+}
+
+
+QList<Diagnostic> ModelValidator::getDiagnostics (void) { return diagnostics; }
+
+
+// column in characters of a column in bytes of a line of UTF-8 content
+static int characterColumn (const QByteArray& content, int line, int column) {
+    int start = 0;
+    for (int l = 1; l < line && start >= 0; l++) {
+        start = content.indexOf('\n', start);
+        if (start >= 0)
+            start++;
+    }
+    if (start < 0)
+        return column;
+    return QString::fromUtf8(content.constData() + start, std::min(column - 1, content.size() - start)).length() + 1;
+}
+
+
+QList<Diagnostic> ModelValidator::check (const QByteArray& content) {
+    TRACE_SCOPE("validate");
+    QList<Diagnostic> res;
+    try {
+        PHIO::parseContent(content.constData(), content.size());
+        return res;
+    } catch (exception_base& x) {
+        Diagnostic d;
+        const string* detail = boost::get_error_info<parse_info>(x);
+        const string* sort = boost::get_error_info<sort_info>(x);
+        const int* process = boost::get_error_info<process_info>(x);
+        if (detail)
+            d.message = QString::fromStdString(*detail);
+        else if (sort && process)
+            d.message = "undeclared process " + QString::fromStdString(*sort) + " " + QString::number(*process);
+        else if (sort)
+            d.message = "unknown sort " + QString::fromStdString(*sort);
+        else
+            d.message = "syntax error";
+        const int* line = boost::get_error_info<line_info>(x);
+        const int* column = boost::get_error_info<column_info>(x);
+        d.line = line ? *line : 0;
+        d.column = (line && column) ? characterColumn(content, *line, *column) : 0;
+        res.append(d);
+    } catch (std::exception& x) {
+        Diagnostic d = { 0, 0, x.what() };
+        res.append(d);
+    }
+    return res;
+}
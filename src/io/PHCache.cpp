@@ -0,0 +1,272 @@
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <boost/make_shared.hpp>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryFile>
+#include "Exceptions.h"
+#include "PHCache.h"
+#include "PHExpander.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+
+using boost::make_shared;
+using std::string;
+using std::vector;
+
+
+// layout of a compiled model: the header, then each section padded to 8 bytes:
+// sorts, sort names, then the action columns (sources, targets, results, rates,
+// stochasticity absorptions, infinite rates). Numbers are stored in native byte order.
+
+static const char magic[4] = { 'P', 'H', 'B', '\n' };
+static const uint32_t byteOrderMark = 0x01020304;
+
+struct PHBHeader {
+    char        magic[4];
+    uint32_t    byteOrder;
+    uint32_t    formatVersion;
+    uint32_t    expanderVersion;
+    char        key[20];
+    int32_t     stochasticityAbsorption;
+    uint32_t    infiniteDefaultRate;
+    uint32_t    reserved;
+    double      defaultRate;
+    uint32_t    sortCount;
+    uint32_t    processCount;
+    uint32_t    actionCount;
+    uint32_t    namesLength;
+};
+
+struct PHBSort {
+    uint32_t    nameOffset;
+    uint32_t    nameLength;
+    int32_t     lastProcess;
+    int32_t     activeProcess;
+};
+
+static size_t padded (size_t n) { return (n + 7) & ~size_t(7); }
+
+// size of each section, in the order they are stored
+static vector<size_t> sectionSizes (const PHBHeader& h) {
+    vector<size_t> sizes;
+    sizes.push_back(sizeof(PHBHeader));
+    sizes.push_back(h.sortCount * sizeof(PHBSort));
+    sizes.push_back(h.namesLength);
+    sizes.push_back(h.actionCount * sizeof(int32_t));
+    sizes.push_back(h.actionCount * sizeof(int32_t));
+    sizes.push_back(h.actionCount * sizeof(int32_t));
+    sizes.push_back(h.actionCount * sizeof(float));
+    sizes.push_back(h.actionCount * sizeof(int32_t));
+    sizes.push_back(h.actionCount * sizeof(uint8_t));
+    return sizes;
+}
+
+
+// SHA-1 of the source content
+QByteArray PHCache::key (const char* content, size_t length) {
+    return QCryptographicHash::hash(QByteArray::fromRawData(content, length), QCryptographicHash::Sha1);
+}
+
+// PAPPL_CACHE_DIR overrides the default directory, the cache is disabled if it is empty
+QString PHCache::directory (void) {
+    if (qgetenv("PAPPL_CACHE_DIR").isNull())
+        return QDir::homePath() + "/.pappl/cache";
+    return QString::fromLocal8Bit(qgetenv("PAPPL_CACHE_DIR"));
+}
+
+QString PHCache::pathFor (const QByteArray& key) {
+    return directory() + "/" + QString(key.toHex()) + ".phb";
+}
+
+
+// read from / write to the cache directory
+PHPtr PHCache::load (const QByteArray& key) {
+    if (directory().isEmpty())
+        return PHPtr();
+    return read(pathFor(key), key);
+}
+
+void PHCache::store (const QByteArray& key, PHPtr ph) {
+    if (!directory().isEmpty() && QDir().mkpath(directory()) && write(pathFor(key), key, ph))
+        prune(maxSize);
+}
+
+
+// the oldest compiled models go first, and files left aside by an interrupted write
+void PHCache::prune (qint64 size) {
+    QDir dir(directory());
+    QDateTime old = QDateTime::currentDateTime().addSecs(-3600);
+    for (const QFileInfo& f : dir.entryInfoList(QStringList() << "*.phb.tmp.*", QDir::Files))
+        if (f.lastModified() < old)
+            QFile::remove(f.filePath());
+    QFileInfoList compiled = dir.entryInfoList(QStringList() << "*.phb", QDir::Files, QDir::Time);
+    qint64 total = 0;
+    for (const QFileInfo& f : compiled)
+        total += f.size();
+    while (total > size && !compiled.isEmpty()) {
+        total -= compiled.last().size();
+        QFile::remove(compiled.takeLast().filePath());
+    }
+}
+
+
+// read a compiled model, anything unexpected makes it a cache miss
+PHPtr PHCache::read (const QString& path, const QByteArray& key) {
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < (qint64) sizeof(PHBHeader))
+        return PHPtr();
+    size_t length = file.size();
+    const char* data = (const char*) file.map(0, length);
+    if (data == NULL)
+        return PHPtr();
+
+    // check the header
+    PHBHeader h;
+    memcpy(&h, data, sizeof(PHBHeader));
+    if (    memcmp(h.magic, magic, sizeof(magic)) || h.byteOrder != byteOrderMark
+        ||  h.formatVersion != (uint32_t) formatVersion || h.expanderVersion != (uint32_t) PHExpander::version
+        ||  key.size() != sizeof(h.key) || memcmp(h.key, key.constData(), sizeof(h.key)))
+        return PHPtr();
+
+    // check the size, and locate the sections
+    vector<size_t> sizes = sectionSizes(h);
+    vector<const char*> sections;
+    size_t offset = 0;
+    for (size_t s : sizes) {
+        sections.push_back(data + offset);
+        offset += padded(s);
+    }
+    if (offset != length)
+        return PHPtr();
+    const PHBSort* sorts = (const PHBSort*) sections[1];
+    const char* names = sections[2];
+    const int32_t* sources = (const int32_t*) sections[3];
+    const int32_t* targets = (const int32_t*) sections[4];
+    const int32_t* results = (const int32_t*) sections[5];
+    const float* rates = (const float*) sections[6];
+    const int32_t* sa = (const int32_t*) sections[7];
+    const uint8_t* infiniteRates = (const uint8_t*) sections[8];
+
+    PHPtr res = make_shared<PH>();
+    res->setInfiniteDefaultRate(h.infiniteDefaultRate);
+    res->setDefaultRate(h.defaultRate);
+    res->setStochasticityAbsorption(h.stochasticityAbsorption);
+
+    // sorts are added in identifier order, so processes get back their identifiers
+    try {
+        for (uint32_t i = 0; i < h.sortCount; i++) {
+            const PHBSort& s = sorts[i];
+            if (s.nameOffset > h.namesLength || s.nameLength > h.namesLength - s.nameOffset)
+                return PHPtr();
+            SortPtr sort = res->addSort(string(names + s.nameOffset, s.nameLength), s.lastProcess);
+            if (sort->getId() != (int) i)
+                return PHPtr();
+            sort->setActiveProcess(s.activeProcess);
+        }
+    } catch (exception_base&) {
+        return PHPtr();
+    }
+    if (res->countProcesses() != (int) h.processCount)
+        return PHPtr();
+
+    // actions are copied column by column
+    for (uint32_t i = 0; i < h.actionCount; i++)
+        if (    (uint32_t) sources[i] >= h.processCount || (uint32_t) targets[i] >= h.processCount
+            ||  (uint32_t) results[i] >= h.processCount)
+            return PHPtr();
+    ActionTable actions;
+    actions.assign(h.actionCount, sources, targets, results, infiniteRates, rates, sa);
+    res->setActionTable(actions);
+
+    return res;
+}
+
+
+// replaces a file at once, readers seeing either the former file or the new one
+static bool replace (const QString& from, const QString& to) {
+#ifdef Q_OS_WIN
+    return MoveFileExW((const wchar_t*) QDir::toNativeSeparators(from).utf16(), (const wchar_t*) QDir::toNativeSeparators(to).utf16()
+                        , MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0;
+#endif
+}
+
+
+// write a compiled model
+bool PHCache::write (const QString& path, const QByteArray& key, PHPtr ph) {
+
+    if (key.size() != sizeof(PHBHeader().key))
+        return false;
+
+    // sorts, in identifier order, and their names
+    vector<PHBSort> sorts;
+    string names;
+    for (int i = 0; i < ph->countSorts(); i++) {
+        SortPtr s = ph->getSort(i);
+        PHBSort e;
+        string name = s->getName();
+        e.nameOffset = names.size();
+        e.nameLength = name.size();
+        e.lastProcess = s->countProcesses() - 1;
+        e.activeProcess = s->getActiveProcess()->getNumber();
+        sorts.push_back(e);
+        names += name;
+    }
+
+    const ActionTable& actions = ph->getActionTable();
+    PHBHeader h;
+    memset(&h, 0, sizeof(PHBHeader));
+    memcpy(h.magic, magic, sizeof(magic));
+    h.byteOrder = byteOrderMark;
+    h.formatVersion = formatVersion;
+    h.expanderVersion = PHExpander::version;
+    memcpy(h.key, key.constData(), sizeof(h.key));
+    h.stochasticityAbsorption = ph->getStochasticityAbsorption();
+    h.infiniteDefaultRate = ph->getInfiniteDefaultRate();
+    h.defaultRate = ph->getDefaultRate();
+    h.sortCount = sorts.size();
+    h.processCount = ph->countProcesses();
+    h.actionCount = actions.size();
+    h.namesLength = names.size();
+
+    vector<const char*> sections;
+    sections.push_back((const char*) &h);
+    sections.push_back((const char*) sorts.data());
+    sections.push_back(names.data());
+    sections.push_back((const char*) actions.getSources().data());
+    sections.push_back((const char*) actions.getTargets().data());
+    sections.push_back((const char*) actions.getResults().data());
+    sections.push_back((const char*) actions.getRates().data());
+    sections.push_back((const char*) actions.getStochasticityAbsorptions().data());
+    sections.push_back((const char*) actions.getInfiniteRates().data());
+    vector<size_t> sizes = sectionSizes(h);
+
+    // write aside, under a name of its own as the same model may be written by several loaders at once,
+    // then replace the former file in one step
+    QTemporaryFile file(path + ".tmp.XXXXXX");
+    if (!file.open())
+        return false;
+    static const char padding[8] = { 0 };
+    bool ok = true;
+    for (size_t i = 0; i < sections.size() && ok; i++) {
+        size_t s = sizes[i];
+        ok = (s == 0 || file.write(sections[i], s) == (qint64) s)
+          && file.write(padding, padded(s) - s) == (qint64) (padded(s) - s);
+    }
+    file.close();
+    ok = ok && replace(file.fileName(), path);
+    // the temporary file is removed unless it became the compiled model
+    file.setAutoRemove(!ok);
+    return ok;
+}
@@ -0,0 +1,634 @@
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+#include "Exceptions.h"
+#include "PHExpander.h"
+
+#define DEFAULT_INFINITE_DEFAULT_RATE true
+#define DEFAULT_RATE 0.
+#define DEFAULT_STOCHASTICITY_ABSORPTION 1
+
+
+// expand a whole PH file
+PHExpander::Result PHExpander::expand (const char* begin, const char* end) {
+    PHExpander expander(begin, end);
+    while (expander.peek().type != Token::End)
+        expander.parseStatement();
+
+    // knocked down sorts start at their lowest level
+    for (const string &s : expander.knockedDown)
+        expander.result.initialState[s] = 0;
+
+    // cooperative sorts start consistently with the sorts they watch
+    for (auto &c : expander.cooperativeSorts) {
+        vector<int> values;
+        for (string &s : c.second)
+            values.push_back(expander.result.initialState[s]);
+        expander.result.initialState[c.first] = expander.cooperativeIndex(c.second, values);
+    }
+
+    return expander.result;
+}
+
+
+PHExpander::PHExpander (const char* begin, const char* end) : position(0) {
+    result.infiniteDefaultRate      = DEFAULT_INFINITE_DEFAULT_RATE;
+    result.defaultRate              = DEFAULT_RATE;
+    result.stochasticityAbsorption  = DEFAULT_STOCHASTICITY_ABSORPTION;
+    result.grn                      = false;
+    tokenize(begin, end);
+}
+
+
+// lexical analysis
+void PHExpander::tokenize (const char* begin, const char* end) {
+
+    int line = 1;
+    const char* lineStart = begin;
+    const char* i = begin;
+
+    while (i < end) {
+
+        // new lines and spaces
+        if (*i == '\n') {
+            line++;
+            lineStart = ++i;
+            continue;
+        }
+        if (isspace((unsigned char) *i)) {
+            i++;
+            continue;
+        }
+
+        Token t;
+        t.line = line;
+        t.column = i - lineStart + 1;
+
+        // comments, possibly nested
+        if (*i == '(' && i + 1 < end && i[1] == '*') {
+            int depth = 0;
+            while (i < end) {
+                if (*i == '(' && i + 1 < end && i[1] == '*') {
+                    depth++;
+                    i += 2;
+                } else if (*i == '*' && i + 1 < end && i[1] == ')') {
+                    i += 2;
+                    if (--depth == 0)
+                        break;
+                } else {
+                    if (*i == '\n') {
+                        line++;
+                        lineStart = i + 1;
+                    }
+                    i++;
+                }
+            }
+            if (depth > 0) {
+                t.type = Token::End;
+                fail(t, "unterminated comment");
+            }
+            continue;
+        }
+
+        const char* start = i;
+        if (isalpha((unsigned char) *i) || *i == '_') {
+            // names (and keywords)
+            t.type = Token::Name;
+            while (i < end && (isalnum((unsigned char) *i) || *i == '_' || *i == '\''))
+                i++;
+        } else if (isdigit((unsigned char) *i)) {
+            // numbers, possibly decimal (rates)
+            t.type = Token::Number;
+            while (i < end && (isdigit((unsigned char) *i) || *i == '.' || *i == 'e' || *i == 'E'
+                    || ((*i == '-' || *i == '+') && (i[-1] == 'e' || i[-1] == 'E'))))
+                i++;
+        } else {
+            // symbols: "->" is the only one that takes two characters
+            t.type = Token::Symbol;
+            i += (*i == '-' && i + 1 < end && i[1] == '>') ? 2 : 1;
+        }
+        t.text = string(start, i);
+        tokens.push_back(t);
+    }
+
+    Token t;
+    t.type = Token::End;
+    t.line = line;
+    t.column = i - lineStart + 1;
+    tokens.push_back(t);
+}
+
+
+// token stream helpers
+
+const PHExpander::Token& PHExpander::peek (int offset) {
+    return tokens[std::min(position + offset, tokens.size() - 1)];
+}
+
+const PHExpander::Token& PHExpander::next () {
+    const Token& t = peek();
+    if (position < tokens.size() - 1)
+        position++;
+    return t;
+}
+
+bool PHExpander::accept (const string& symbol) {
+    if (peek().type == Token::End || peek().text != symbol)
+        return false;
+    next();
+    return true;
+}
+
+void PHExpander::expect (const string& symbol) {
+    if (!accept(symbol))
+        fail(peek(), "\"" + symbol + "\" expected");
+}
+
+string PHExpander::expectName () {
+    if (peek().type != Token::Name)
+        fail(peek(), "name expected");
+    return next().text;
+}
+
+int PHExpander::expectNumber () {
+    if (peek().type != Token::Number || peek().text.find_first_not_of("0123456789") != string::npos)
+        fail(peek(), "integer expected");
+    return atoi(next().text.c_str());
+}
+
+double PHExpander::expectRate (bool& infinite) {
+    infinite = accept("Inf");
+    if (infinite)
+        return 0.;
+    if (peek().type != Token::Number)
+        fail(peek(), "rate expected");
+    return strtod(next().text.c_str(), NULL);
+}
+
+void PHExpander::fail (const Token& t, const string& message) {
+    string near = (t.type == Token::End) ? "end of file" : "\"" + t.text + "\"";
+    throw ph_parse_error()
+            << parse_info("line " + boost::lexical_cast<string>(t.line) + ", character "
+                + boost::lexical_cast<string>(t.column) + ": " + message + " near " + near)
+            << line_info(t.line)
+            << column_info(t.column);
+}
+
+
+// statements
+
+void PHExpander::parseStatement () {
+    const Token& t = peek();
+    if (t.type != Token::Name)
+        fail(t, "instruction expected");
+
+    if (t.text == "directive")              parseDirective();
+    else if (t.text == "process")           parseProcess();
+    else if (t.text == "initial_state")     parseInitialState();
+    else if (t.text == "COOPERATIVITY")     parseCooperativity();
+    else if (t.text == "KNOCKDOWN")         parseKnockdown();
+    else if (t.text == "RM")                parseRm();
+    else if (t.text == "GRN")               parseGrn();
+    else {
+        ActionDecl a = parseAction();
+        result.actions.push_back(a);
+    }
+}
+
+// directive default_rate 1. | directive stochasticity_absorption 10 | directive sample 40.
+void PHExpander::parseDirective () {
+    next();
+    const Token& name = peek();
+    string directive = expectName();
+    if (directive == "default_rate") {
+        result.defaultRate = expectRate(result.infiniteDefaultRate);
+    } else if (directive == "stochasticity_absorption") {
+        result.stochasticityAbsorption = expectNumber();
+    } else if (directive == "sample") {
+        // only meaningful for simulations
+        bool infinite;
+        expectRate(infinite);
+    } else {
+        fail(name, "unknown directive");
+    }
+}
+
+// process a 1
+void PHExpander::parseProcess () {
+    next();
+    const Token& where = peek();
+    string name = expectName();
+    int last = expectNumber();
+    if (cooperativeSorts.count(name))
+        fail(where, "sort " + name + " already declared as a cooperative sort");
+    if (processes.count(name))
+        fail(where, "sort " + name + " already declared");
+    processes[name] = last;
+    result.sorts.push_back(pair<string, int>(name, last));
+}
+
+// initial_state a 1, b 0
+void PHExpander::parseInitialState () {
+    next();
+    do {
+        const Token& where = peek();
+        string sort = expectName();
+        int p = expectNumber();
+        checkProcess(sort, p, where);
+        result.initialState[sort] = p;
+    } while (accept(",")
+            || (peek().type == Token::Name && peek(1).type == Token::Number && peek(2).text != "->"));
+}
+
+// a 1 -> b 0 1 @1.~10
+PHExpander::ActionDecl PHExpander::parseAction () {
+    ActionDecl a;
+
+    const Token& hitter = peek();
+    a.hitterSort = expectName();
+    a.hitter = expectNumber();
+    checkProcess(a.hitterSort, a.hitter, hitter);
+    expect("->");
+    const Token& target = peek();
+    a.targetSort = expectName();
+    a.target = expectNumber();
+    a.result = expectNumber();
+    checkProcess(a.targetSort, a.target, target);
+    checkProcess(a.targetSort, a.result, target);
+
+    a.infiniteRate  = result.infiniteDefaultRate;
+    a.rate          = result.defaultRate;
+    a.sa            = result.stochasticityAbsorption;
+    if (accept("@"))
+        a.rate = expectRate(a.infiniteRate);
+    if (accept("~"))
+        a.sa = expectNumber();
+
+    return a;
+}
+
+// COOPERATIVITY([a;b] -> c 0 1, [[1;1]]) or COOPERATIVITY(<state matching>, c, 0, 1)
+void PHExpander::parseCooperativity () {
+    const Token& macro = next();
+    expect("(");
+
+    // find out which form is used: the legacy one has "->" right after the sort list
+    size_t afterList = position;
+    if (peek().text == "[") {
+        while (afterList < tokens.size() - 1 && tokens[afterList].text != "]")
+            afterList++;
+        afterList++;
+    }
+
+    if (afterList < tokens.size() && tokens[afterList].text == "->") {
+
+        const Token& where = peek();
+        vector<string> sorts = parseSortList();
+        for (string &s : sorts)
+            lastProcess(s, where);
+        expect("->");
+        const Token& target = peek();
+        string targetSort = expectName();
+        int j = expectNumber();
+        int k = expectNumber();
+        checkProcess(targetSort, j, target);
+        checkProcess(targetSort, k, target);
+        expect(",");
+        vector< vector<int> > states = parseStates(sorts.size());
+        expect(")");
+
+        string coop = makeCooperativeSort(sorts, macro);
+        for (vector<int> &state : states) {
+            for (size_t i = 0; i < sorts.size(); i++)
+                checkProcess(sorts[i], state[i], where);
+            addAction(coop, cooperativeIndex(sorts, state), targetSort, j, k);
+        }
+
+    } else {
+
+        int formula = parseFormula();
+        expect(",");
+        const Token& target = peek();
+        string targetSort = expectName();
+        expect(",");
+        int j = expectNumber();
+        expect(",");
+        int k = expectNumber();
+        expect(")");
+        checkProcess(targetSort, j, target);
+        checkProcess(targetSort, k, target);
+
+        // as phc does, a single cooperative sort over all the sorts of the formula,
+        // with one action for each of its states matching the formula
+        vector<string> sorts;
+        formulaSorts(formula, sorts);
+        string coop = makeCooperativeSort(sorts, macro);
+
+        int count = processes[coop] + 1;
+        for (int i = 0; i < count; i++) {
+            vector<int> values = cooperativeValues(sorts, i);
+            map<string, int> state;
+            for (size_t s = 0; s < sorts.size(); s++)
+                state[sorts[s]] = values[s];
+            if (holds(formula, state))
+                addAction(coop, i, targetSort, j, k);
+        }
+    }
+}
+
+// KNOCKDOWN(a): a can only go down
+void PHExpander::parseKnockdown () {
+    next();
+    expect("(");
+    const Token& where = peek();
+    string sort = expectName();
+    expect(")");
+    lastProcess(sort, where);
+    knockedDown.insert(sort);
+
+    vector<ActionDecl> kept;
+    for (ActionDecl &a : result.actions)
+        if (a.targetSort != sort || a.result < a.target)
+            kept.push_back(a);
+    result.actions.swap(kept);
+}
+
+// RM({a 1 -> b 0 1; c 0 -> b 1 0})
+void PHExpander::parseRm () {
+    next();
+    expect("(");
+    expect("{");
+    while (!accept("}")) {
+        removeAction(parseAction());
+        if (!accept(";")) {
+            expect("}");
+            break;
+        }
+    }
+    expect(")");
+}
+
+// GRN([a 1 -> + b; c 1 -> - b])
+void PHExpander::parseGrn () {
+    next();
+    result.grn = true;
+    expect("(");
+    expect("[");
+    vector<string> regulators;
+    set<string> regulated;
+    while (!accept("]")) {
+        const Token& regulator = peek();
+        string a = expectName();
+        int i = expectNumber();
+        checkProcess(a, i, regulator);
+        expect("->");
+        bool activation = accept("+");
+        if (!activation)
+            expect("-");
+        const Token& target = peek();
+        string b = expectName();
+        int last = lastProcess(b, target);
+        if (std::find(regulators.begin(), regulators.end(), a) == regulators.end())
+            regulators.push_back(a);
+        regulated.insert(b);
+
+        // from its threshold on, an activator raises the target one level at a time and an
+        // inhibitor lowers it; below its threshold, the regulator moves the target the other way
+        for (int r = 0; r <= processes[a]; r++) {
+            bool raise = (r >= i) == activation;
+            for (int l = 0; l < last; l++) {
+                if (raise)
+                    addAction(a, r, b, l, l + 1);
+                else
+                    addAction(a, r, b, l + 1, l);
+            }
+        }
+
+        if (!accept(";")) {
+            expect("]");
+            break;
+        }
+    }
+    expect(")");
+
+    // the inputs (regulators not regulated) degrade one level at a time
+    for (string &a : regulators)
+        if (!regulated.count(a))
+            for (int l = processes[a]; l > 0; l--)
+                addAction(a, l, a, l, l - 1);
+}
+
+
+// COOPERATIVITY helpers
+
+// [a;b;c]
+vector<string> PHExpander::parseSortList () {
+    vector<string> sorts;
+    expect("[");
+    do {
+        sorts.push_back(expectName());
+    } while (accept(";"));
+    expect("]");
+    return sorts;
+}
+
+// [[0;1];[1;1]]
+vector< vector<int> > PHExpander::parseStates (size_t width) {
+    vector< vector<int> > states;
+    expect("[");
+    do {
+        const Token& where = peek();
+        vector<int> state;
+        expect("[");
+        do {
+            state.push_back(expectNumber());
+        } while (accept(";"));
+        expect("]");
+        if (state.size() != width)
+            fail(where, "state does not match the list of sorts");
+        states.push_back(state);
+    } while (accept(";"));
+    expect("]");
+    return states;
+}
+
+// disjunction of conjunctions
+int PHExpander::parseFormula () {
+    int left = parseConjunction();
+    while (accept("or")) {
+        Formula f;
+        f.type = Formula::Or;
+        f.children.push_back(left);
+        f.children.push_back(parseConjunction());
+        formulas.push_back(f);
+        left = formulas.size() - 1;
+    }
+    return left;
+}
+
+int PHExpander::parseConjunction () {
+    int left = parseFormulaAtom();
+    while (accept("and")) {
+        Formula f;
+        f.type = Formula::And;
+        f.children.push_back(left);
+        f.children.push_back(parseFormulaAtom());
+        formulas.push_back(f);
+        left = formulas.size() - 1;
+    }
+    return left;
+}
+
+// not f | (f) | [a;b] in [[0;1]]
+int PHExpander::parseFormulaAtom () {
+    Formula f;
+    if (accept("not")) {
+        f.type = Formula::Not;
+        f.children.push_back(parseFormulaAtom());
+    } else if (accept("(")) {
+        int inner = parseFormula();
+        expect(")");
+        return inner;
+    } else {
+        const Token& where = peek();
+        f.type = Formula::In;
+        f.sorts = parseSortList();
+        for (string &s : f.sorts)
+            lastProcess(s, where);
+        expect("in");
+        f.states = parseStates(f.sorts.size());
+    }
+    formulas.push_back(f);
+    return formulas.size() - 1;
+}
+
+// the sorts of the formula, in order of appearance
+void PHExpander::formulaSorts (int formula, vector<string>& sorts) {
+    Formula& f = formulas[formula];
+    for (string &s : f.sorts)
+        if (std::find(sorts.begin(), sorts.end(), s) == sorts.end())
+            sorts.push_back(s);
+    for (int c : f.children)
+        formulaSorts(c, sorts);
+}
+
+// does the state (of all the sorts of the formula) match it?
+bool PHExpander::holds (int formula, const map<string, int>& state) {
+    Formula& f = formulas[formula];
+    switch (f.type) {
+        case Formula::In:   return matches(formula, state);
+        case Formula::Not:  return !holds(f.children[0], state);
+        case Formula::And:  return holds(f.children[0], state) && holds(f.children[1], state);
+        default:            return holds(f.children[0], state) || holds(f.children[1], state);
+    }
+}
+
+// does the state match the "in" clause?
+bool PHExpander::matches (int formula, const map<string, int>& state) {
+    Formula& f = formulas[formula];
+    for (vector<int> &s : f.states) {
+        bool match = true;
+        for (size_t i = 0; i < f.sorts.size() && match; i++)
+            match = state.find(f.sorts[i])->second == s[i];
+        if (match)
+            return true;
+    }
+    return false;
+}
+
+// declare (once) the sort which processes reflect the state of the given sorts,
+// the first sort of the list being the most significant
+string PHExpander::makeCooperativeSort (const vector<string>& sorts, const Token& where) {
+
+    // no need to watch a single sort
+    if (sorts.size() == 1)
+        return sorts[0];
+
+    string name;
+    for (const string &s : sorts)
+        name += (name.empty() ? "" : "_and_") + s;
+    if (cooperativeSorts.count(name))
+        return name;
+    if (processes.count(name))
+        fail(where, "cooperative sort " + name + " has the name of a declared sort");
+
+    int count = 1;
+    for (const string &s : sorts)
+        count *= processes[s] + 1;
+    processes[name] = count - 1;
+    result.sorts.push_back(pair<string, int>(name, count - 1));
+    cooperativeSorts[name] = sorts;
+
+    // each change of one of the sorts is reflected in the cooperative sort
+    for (size_t s = 0; s < sorts.size(); s++)
+        for (int i = 0; i < count; i++) {
+            vector<int> values = cooperativeValues(sorts, i);
+            int current = values[s];
+            for (int v = 0; v <= processes[sorts[s]]; v++) {
+                if (v == current)
+                    continue;
+                values[s] = v;
+                addAction(sorts[s], v, name, i, cooperativeIndex(sorts, values));
+            }
+        }
+
+    return name;
+}
+
+int PHExpander::cooperativeIndex (const vector<string>& sorts, const vector<int>& values) {
+    int index = 0;
+    for (size_t s = 0; s < sorts.size(); s++)
+        index = index * (processes[sorts[s]] + 1) + values[s];
+    return index;
+}
+
+vector<int> PHExpander::cooperativeValues (const vector<string>& sorts, int index) {
+    vector<int> values(sorts.size());
+    for (int s = sorts.size() - 1; s >= 0; s--) {
+        int size = processes[sorts[s]] + 1;
+        values[s] = index % size;
+        index /= size;
+    }
+    return values;
+}
+
+
+// model helpers
+
+int PHExpander::lastProcess (const string& sort, const Token& where) {
+    map<string, int>::iterator f = processes.find(sort);
+    if (f == processes.end())
+        throw sort_not_found() << sort_info(sort) << line_info(where.line) << column_info(where.column);
+    return f->second;
+}
+
+void PHExpander::checkProcess (const string& sort, int process, const Token& where) {
+    if (process > lastProcess(sort, where))
+        throw process_not_found() << process_info(process) << sort_info(sort)
+                << line_info(where.line) << column_info(where.column);
+}
+
+// add an action generated by a macro (default rate and stochasticity absorption)
+void PHExpander::addAction (const string& hitterSort, int hitter, const string& targetSort, int target, int res) {
+    ActionDecl a;
+    a.hitterSort    = hitterSort;
+    a.hitter        = hitter;
+    a.targetSort    = targetSort;
+    a.target        = target;
+    a.result        = res;
+    a.infiniteRate  = result.infiniteDefaultRate;
+    a.rate          = result.defaultRate;
+    a.sa            = result.stochasticityAbsorption;
+    result.actions.push_back(a);
+}
+
+// remove the actions matching a (whatever their rates)
+void PHExpander::removeAction (const ActionDecl& a) {
+    vector<ActionDecl> kept;
+    for (ActionDecl &b : result.actions)
+        if (!(      b.hitterSort == a.hitterSort && b.hitter == a.hitter
+                &&  b.targetSort == a.targetSort && b.target == a.target && b.result == a.result))
+            kept.push_back(b);
+    result.actions.swap(kept);
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <boost/random/bernoulli_distribution.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include "PHGenerator.h"
+
+using std::pair;
+using std::set;
+using std::vector;
+
+// boost distributions rather than std ones, whose output differs between standard libraries
+typedef boost::random::mt19937 Generator;
+
+
+PHGenerator::Options::Options (void)
+    : seed(1), sorts(100), processes(3), density(4.), regulators(2)
+    , topology(ScaleFree), groups(4), macros(.1), rates(.5) {}
+
+
+bool PHGenerator::topologyFromName (const string& name, Topology& topology) {
+    if (name == "scale-free")       topology = ScaleFree;
+    else if (name == "modular")     topology = Modular;
+    else if (name == "layered")     topology = Layered;
+    else return false;
+    return true;
+}
+
+
+// uniform in [min, max]
+static int draw (Generator& gen, int min, int max) {
+    return boost::random::uniform_int_distribution<int>(min, max)(gen);
+}
+
+static bool chance (Generator& gen, double p) {
+    return boost::random::bernoulli_distribution<double>(std::min(1., std::max(0., p)))(gen);
+}
+
+
+// the sorts hitting each sort, according to the topology
+static vector< vector<int> > skeleton (Generator& gen, const PHGenerator::Options& o) {
+
+    int n = o.sorts;
+    int groups = std::max(1, std::min(o.groups, n));
+    vector< vector<int> > hitters(n);
+
+    // hubs: each sort is picked once, plus once per sort it already hits
+    vector<int> ends;
+
+    for (int t = 0; t < n; t++) {
+
+        // candidates are taken in [first, last], "ends" being used instead for scale-free graphs
+        int group = (long long) t * groups / n;
+        int first = 0, last = n - 1;
+        if (o.topology == PHGenerator::Modular) {
+            first = ((long long) group * n + groups - 1) / groups;
+            last = ((long long) (group + 1) * n + groups - 1) / groups - 1;
+        } else if (o.topology == PHGenerator::Layered) {
+            // the first layer is made of inputs, which only regulate themselves
+            int layer = group > 0 ? group - 1 : 0;
+            first = ((long long) layer * n + groups - 1) / groups;
+            last = group > 0 ? ((long long) (layer + 1) * n + groups - 1) / groups - 1 : t;
+            if (group == 0)
+                first = t;
+        }
+        int candidates = o.topology == PHGenerator::ScaleFree ? t : last - first + 1;
+
+        int count = std::min(draw(gen, 1, std::max(1, 2 * o.regulators - 1)), candidates);
+        set<int> picked;
+        if (candidates == 0) {
+            picked.insert(t);
+        }
+        while ((int) picked.size() < count) {
+            int h;
+            if (o.topology == PHGenerator::ScaleFree)
+                h = ends[draw(gen, 0, ends.size() - 1)];
+            else if (o.topology == PHGenerator::Modular && chance(gen, .1))
+                h = draw(gen, 0, n - 1);
+            else
+                h = draw(gen, first, last);
+            picked.insert(h);
+        }
+
+        hitters[t].assign(picked.begin(), picked.end());
+        ends.push_back(t);
+        for (int h : hitters[t])
+            if (h != t)
+                ends.push_back(h);
+    }
+
+    return hitters;
+}
+
+
+int PHGenerator::write (std::ostream& output, const Options& o) {
+
+    Generator gen(o.seed);
+    int n = std::max(1, o.sorts);
+    int maxLast = std::max(1, o.processes - 1);
+    static const char* rates[] = { "0.1", "0.5", "1.", "5.", "10." };
+    static const char* sas[] = { "10", "50", "100" };
+
+    output << "(* generated: seed " << o.seed << ", " << n << " sorts *)\n";
+
+    // sorts, with the number of their last process
+    vector<int> lastProcess(n);
+    for (int s = 0; s < n; s++) {
+        lastProcess[s] = draw(gen, 1, maxLast);
+        output << "process s" << s << " " << lastProcess[s] << "\n";
+    }
+
+    Options options = o;
+    options.sorts = n;
+    vector< vector<int> > hitters = skeleton(gen, options);
+
+    // actions along the edges of the skeleton, macros being kept for the end
+    int written = 0;
+    std::ostringstream grn;
+    for (int t = 0; t < n; t++) {
+
+        const vector<int>& regulators = hitters[t];
+        double perEdge = o.density / regulators.size();
+
+        // two regulators needed together
+        if (regulators.size() >= 2 && chance(gen, o.macros)) {
+            int a = regulators[0], b = regulators[1];
+            int j = draw(gen, 0, lastProcess[t] - 1);
+            output  << "COOPERATIVITY([s" << a << ";s" << b << "] -> s" << t << " " << j << " " << j + 1
+                    << ", [[" << lastProcess[a] << ";" << lastProcess[b] << "]])\n";
+            written++;
+        }
+
+        set< vector<int> > actions;
+        for (int h : regulators) {
+
+            if (chance(gen, o.macros)) {
+                grn << (grn.tellp() > 0 ? ";\n\t" : "\t") << "s" << h << " " << draw(gen, 1, lastProcess[h])
+                    << " -> " << (chance(gen, .7) ? "+" : "-") << " s" << t;
+                written++;
+                continue;
+            }
+
+            int count = draw(gen, 1, std::max(1, (int) (2 * perEdge + .5) - 1));
+            for (int attempt = 0; attempt < 4 * count && count > 0; attempt++) {
+                int i = draw(gen, 0, lastProcess[h]);
+                int j = draw(gen, 0, lastProcess[t]);
+                int k = (j == 0 || (j < lastProcess[t] && chance(gen, .5))) ? j + 1 : j - 1;
+                if (h == t && i != j)
+                    continue;
+                int key[] = { h, i, j, k };
+                if (!actions.insert(vector<int>(key, key + 4)).second)
+                    continue;
+                output << "s" << h << " " << i << " -> s" << t << " " << j << " " << k;
+                if (chance(gen, o.rates))
+                    output << " @" << rates[draw(gen, 0, 4)] << "~" << sas[draw(gen, 0, 2)];
+                output << "\n";
+                written++;
+                count--;
+            }
+        }
+    }
+
+    if (grn.tellp() > 0)
+        output << "GRN([\n" << grn.str() << "\n])\n";
+
+    // initial state, sorts not listed start at 0
+    bool first = true;
+    for (int s = 0; s < n; s++) {
+        int p = draw(gen, 0, lastProcess[s]);
+        if (p == 0)
+            continue;
+        output << (first ? "initial_state " : ", ") << "s" << s << " " << p;
+        first = false;
+    }
+    if (!first)
+        output << "\n";
+
+    return written;
+}
+
+
+string PHGenerator::generate (const Options& options) {
+    std::ostringstream output;
+    write(output, options);
+    return output.str();
+}
@@ -1,10 +1,14 @@
 #pragma GCC diagnostic ignored "-Wparentheses"
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <QFile>
 #include <QProcess>
 #include <QString>
 #include <QStringList>
@@ -16,7 +20,10 @@
 #include "axe.h"
 #include "Exceptions.h"
 #include "IO.h"
+#include "PHCache.h"
+#include "PHExpander.h"
 #include "PHIO.h"
+#include "Trace.h"
 #include "Area.h"
 
 
@@ -25,9 +32,225 @@ using std::string;
 using std::vector;
 
 
+// single pass scanner for the dump format: each character is read once,
+// without backtracking, and sorts are only looked up when the name changes
+class DumpScanner {
+
+    public:
+
+        DumpScanner (const char* begin, const char* end) : i(begin), end(end), line(1), lastHitter(), lastTarget() {
+            res = make_shared<PH>();
+        }
+
+        PHPtr scan () {
+            bool footer = false;
+            while (i < end) {
+                skipSpaces();
+                if (i == end)
+                    break;
+                if (*i == '\n') {
+                    nextLine();
+                    continue;
+                }
+
+                const char* word = i;
+                size_t length = name();
+                if (length == 13 && !strncmp(word, "initial_state", 13)) {
+                    initialState();
+                    footer = true;
+                } else if (footer) {
+                    fail();
+                } else if (length == 7 && !strncmp(word, "process", 7)) {
+                    process();
+                } else {
+                    action(word, length);
+                }
+                endOfLine();
+            }
+            return res;
+        }
+
+    private:
+
+        // process NAME N
+        void process () {
+            skipSpaces();
+            const char* word = i;
+            size_t length = name();
+            skipSpaces();
+            int processes = number();
+            res->addSort(string(word, length), processes);
+        }
+
+        // a i -> b j k [@rate[~sa]]
+        void action (const char* hitter, size_t hitterLength) {
+            skipSpaces();
+            int source = number();
+            skipSpaces();
+            if (end - i < 2 || i[0] != '-' || i[1] != '>')
+                fail();
+            i += 2;
+            skipSpaces();
+            const char* target = i;
+            size_t targetLength = name();
+            skipSpaces();
+            int targetProcess = number();
+            skipSpaces();
+            int resultProcess = number();
+            skipSpaces();
+
+            bool infinite = res->getInfiniteDefaultRate();
+            double rate = res->getDefaultRate();
+            int sa = res->getStochasticityAbsorption();
+            if (i < end && *i == '@') {
+                i++;
+                skipSpaces();
+                if (end - i >= 3 && !strncmp(i, "Inf", 3)) {
+                    infinite = true;
+                    i += 3;
+                } else {
+                    infinite = false;
+                    rate = real();
+                }
+                skipSpaces();
+                if (i < end && *i == '~') {
+                    i++;
+                    skipSpaces();
+                    sa = number();
+                }
+            }
+
+            lookup(lastHitter, hitter, hitterLength);
+            lookup(lastTarget, target, targetLength);
+            res->addAction(	lastHitter->getProcess(source)
+                        ,	lastTarget->getProcess(targetProcess)
+                        ,	lastTarget->getProcess(resultProcess)
+                        ,	infinite, rate, sa);
+        }
+
+        // initial_state a i, b j...
+        void initialState () {
+            for (;;) {
+                skipSpaces();
+                const char* word = i;
+                size_t length = name();
+                skipSpaces();
+                int process = number();
+                res->getSort(string(word, length))->setActiveProcess(process);
+                skipSpaces();
+                if (i == end || *i != ',')
+                    break;
+                i++;
+            }
+        }
+
+        // the sort is only looked up when the name differs from the previous one
+        void lookup (SortPtr& cache, const char* word, size_t length) {
+            if (!cache || cache->getName().compare(0, string::npos, word, length) != 0)
+                cache = res->getSort(string(word, length));
+        }
+
+        // spaces and (nested) comments, which may span several lines
+        void skipSpaces () {
+            while (i < end) {
+                if (*i == ' ' || *i == '\t' || *i == '\r')
+                    i++;
+                else if (*i == '(' && i + 1 < end && i[1] == '*')
+                    comment();
+                else
+                    return;
+            }
+        }
+
+        void comment () {
+            int depth = 0;
+            do {
+                if (*i == '(' && i + 1 < end && i[1] == '*') {
+                    depth++;
+                    i += 2;
+                } else if (*i == '*' && i + 1 < end && i[1] == ')') {
+                    depth--;
+                    i += 2;
+                } else {
+                    if (*i == '\n')
+                        line++;
+                    i++;
+                }
+            } while (depth > 0 && i < end);
+            if (depth > 0)
+                fail();
+        }
+
+        size_t name () {
+            const char* start = i;
+            if (i == end || !(isalpha((unsigned char) *i) || *i == '_'))
+                fail();
+            while (i < end && (isalnum((unsigned char) *i) || *i == '_' || *i == '\''))
+                i++;
+            return i - start;
+        }
+
+        int number () {
+            if (i == end || !isdigit((unsigned char) *i))
+                fail();
+            int n = 0;
+            while (i < end && isdigit((unsigned char) *i))
+                n = n * 10 + (*i++ - '0');
+            return n;
+        }
+
+        double real () {
+            // copy the token: the buffer is not null terminated
+            char token[64];
+            size_t length = 0;
+            while (i + length < end && length < sizeof(token) - 1 && (isdigit((unsigned char) i[length]) || (i[length] && strchr("+-.eE", i[length]))))
+                length++;
+            memcpy(token, i, length);
+            token[length] = '\0';
+            char* last;
+            double d = strtod(token, &last);
+            if (length == 0 || last != token + length)
+                fail();
+            i += length;
+            return d;
+        }
+
+        // the line must be over, go to the next one
+        void endOfLine () {
+            skipSpaces();
+            if (i < end && *i != '\n')
+                fail();
+            if (i < end)
+                nextLine();
+        }
+
+        void nextLine () {
+            i++;
+            line++;
+        }
+
+        void fail () {
+            throw ph_parse_error() << line_info(line);
+        }
+
+        const char* i;
+        const char* end;
+        int line;
+        PHPtr res;
+        SortPtr lastHitter;
+        SortPtr lastTarget;
+};
+
+
 // process actual parsing, finally
+PHPtr PHIO::parse (const char* input, size_t length) {
+    return DumpScanner(input, input + length).scan();
+}
+
+
+// former AXE grammar, kept as a reference for the scanner
 typedef const char* CCHAR;
-PHPtr PHIO::parse (string const& input) {
+PHPtr PHIO::parseWithAxe (string const& input) {
 
     using namespace axe;
     PHPtr res = make_shared<PH>();
@@ -53,8 +276,7 @@ PHPtr PHIO::parse (string const& input) {
     int processes;
     auto sort_name = (r_alpha() | r_char('_')) & *(r_any("_'") | r_alnum());
     auto sort_declaration = (r_str("process") & space & (sort_name >> sortName) & space & r_ufixed(processes)) >> e_ref([&](CCHAR i1, CCHAR i2) {
-        SortPtr s = Sort::make(sortName, processes);
-        res->addSort(s);
+        res->addSort(sortName, processes);
     });
     auto sort_declaration_line = sort_declaration & trailing_spaces;
 
@@ -71,27 +293,24 @@ PHPtr PHIO::parse (string const& input) {
     auto action_with_rate 	= action_required & space & r_lit("@") & space & action_rate;
     auto action_with_stoch 	= (action_with_rate & space & r_lit("~") & space & r_ufixed(actStoch));
     auto action = 			action_with_stoch >> e_ref([&](CCHAR i1, CCHAR i2) {
-                                ActionPtr action = make_shared<Action>(	res->getSort(actSort1)->getProcess(actProc1)
-                                                                    ,	res->getSort(actSort2)->getProcess(actProc2)
-                                                                    ,	res->getSort(actSort2)->getProcess(actProc3)
-                                                                    ,	infiniteActRate, actRate, actStoch);
-                                res->addAction(action);
+                                res->addAction(	res->getSort(actSort1)->getProcess(actProc1)
+                                            ,	res->getSort(actSort2)->getProcess(actProc2)
+                                            ,	res->getSort(actSort2)->getProcess(actProc3)
+                                            ,	infiniteActRate, actRate, actStoch);
                         })
                         |	action_with_rate >> e_ref([&](CCHAR i1, CCHAR i2) {
-                                ActionPtr action = make_shared<Action>(	res->getSort(actSort1)->getProcess(actProc1)
-                                                                    ,	res->getSort(actSort2)->getProcess(actProc2)
-                                                                    ,	res->getSort(actSort2)->getProcess(actProc3)
-                                                                    ,	infiniteActRate, actRate
-                                                                    ,	res->getStochasticityAbsorption());
-                                res->addAction(action);
+                                res->addAction(	res->getSort(actSort1)->getProcess(actProc1)
+                                            ,	res->getSort(actSort2)->getProcess(actProc2)
+                                            ,	res->getSort(actSort2)->getProcess(actProc3)
+                                            ,	infiniteActRate, actRate
+                                            ,	res->getStochasticityAbsorption());
                         })
                         |	action_required >> e_ref([&](CCHAR i1, CCHAR i2) {
-                                ActionPtr action = make_shared<Action>(	res->getSort(actSort1)->getProcess(actProc1)
-                                                                    ,	res->getSort(actSort2)->getProcess(actProc2)
-                                                                    ,	res->getSort(actSort2)->getProcess(actProc3)
-                                                                    ,	res->getInfiniteDefaultRate(), res->getDefaultRate()
-                                                                    ,	res->getStochasticityAbsorption());
-                                res->addAction(action);
+                                res->addAction(	res->getSort(actSort1)->getProcess(actProc1)
+                                            ,	res->getSort(actSort2)->getProcess(actProc2)
+                                            ,	res->getSort(actSort2)->getProcess(actProc3)
+                                            ,	res->getInfiniteDefaultRate(), res->getDefaultRate()
+                                            ,	res->getStochasticityAbsorption());
                         });
     auto action_line = action & trailing_spaces;
 
@@ -126,18 +345,138 @@ PHPtr PHIO::parse (string const& input) {
 }
 
 
-// parse file
-PHPtr PHIO::parseFile (string const& path) {
+// can the line (split into tokens) be read by the dump grammar as is?
+static bool isBasicLine (vector<string> const& tokens) {
+
+    auto isName = [](string const& t) {
+        if (t.empty() || !(isalpha((unsigned char) t[0]) || t[0] == '_'))
+            return false;
+        for (char c : t)
+            if (!(isalnum((unsigned char) c) || c == '_' || c == '\''))
+                return false;
+        return true;
+    };
+    auto isNumber = [](string const& t) {
+        if (t.empty())
+            return false;
+        for (char c : t)
+            if (!isdigit((unsigned char) c))
+                return false;
+        return true;
+    };
+
+    // blank line (or comments only)
+    if (tokens.empty())
+        return true;
+
+    // process declaration: one per line
+    if (tokens[0] == "process")
+        return tokens.size() == 3 && isName(tokens[1]) && isNumber(tokens[2]);
+
+    // footer
+    if (tokens[0] == "initial_state")
+        return true;
+
+    // action: a i -> b j k, optionally followed by @rate~sa
+    return      tokens.size() >= 6
+            &&  isName(tokens[0]) && isNumber(tokens[1])
+            &&  tokens[2] == "->"
+            &&  isName(tokens[3]) && isNumber(tokens[4]) && isNumber(tokens[5])
+            &&  (tokens.size() == 6 || tokens[6][0] == '@');
+}
+
+
+// pre-scan: does the input only contain basic PH instructions (as dumped by phc)?
+bool PHIO::isBasicForm (const char* input, size_t length) {
+
+    vector<string> tokens;
+    string token;
+    int commentDepth = 0;
+
+    for (size_t i = 0; i <= length; i++) {
+
+        // handle the last line as if it was terminated
+        char c = (i < length) ? input[i] : '\n';
+        char next = (i + 1 < length) ? input[i + 1] : '\0';
+
+        // skip (nested) comments, they may span several lines
+        if (c == '(' && next == '*') {
+            commentDepth++;
+            i++;
+            continue;
+        }
+        if (commentDepth > 0) {
+            if (c == '*' && next == ')') {
+                commentDepth--;
+                i++;
+            }
+            continue;
+        }
+
+        // split lines into tokens
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            if (!token.empty()) {
+                tokens.push_back(token);
+                token.clear();
+            }
+            if (c == '\n') {
+                if (!isBasicLine(tokens))
+                    return false;
+                tokens.clear();
+            }
+        } else {
+            token += c;
+        }
+    }
+
+    return commentDepth == 0;
+}
+
+
+// dump content using phc -l dump
+// (this command transforms complex PH instructions in basic ones)
+QByteArray PHIO::dumpWithPhc (string const& path) {
+
+    TRACE_SCOPE("phc", path);
+
+    // phc cannot read compressed files: their content is given on its standard input
+    QFile file(QString::fromUtf8(path.c_str()));
+    QByteArray magic = file.open(QIODevice::ReadOnly) ? file.peek(2) : QByteArray();
+    bool compressed = IO::isCompressed(magic.constData(), magic.size());
+    file.close();
+    if (compressed) {
+        string content = IO::readFile(path);
+        return dumpWithPhc(content.data(), content.size());
+    }
 
-    // dump content using phc -l dump
-    // (this command transforms complex PH instructions in basic ones)
-    QString phc = "phc";
     QStringList args;
     args << "-l" << "dump" << "-i" << QString::fromUtf8(path.c_str()) << "--no-debug";
+    return runPhc(args, NULL, 0);
+
+}
+
+
+// dump content given on the standard input of phc
+QByteArray PHIO::dumpWithPhc (const char* input, size_t length) {
+    QStringList args;
+    args << "-l" << "dump" << "--no-debug";
+    return runPhc(args, input, length);
+}
+
+
+// run phc, the input (if any) being given on its standard input
+QByteArray PHIO::runPhc (QStringList const& args, const char* input, size_t length) {
+
+    QString phc = "phc";
     QProcess *phcProcess = new QProcess();
     phcProcess->start(phc, args);
-    if (!phcProcess->waitForStarted())
+    if (!phcProcess->waitForStarted()) {
+        delete phcProcess;
         throw pint_program_not_found() << file_info("phc");
+    }
+    if (input != NULL)
+        phcProcess->write(input, length);
+    phcProcess->closeWriteChannel();
 
     // read result
     QByteArray stderr;
@@ -150,14 +489,161 @@ PHPtr PHIO::parseFile (string const& path) {
     stdout += phcProcess->readAllStandardOutput();
     delete phcProcess;    
 
-    // parse dump
     if (!stderr.isEmpty())
         throw pint_phc_crash() << parse_info(QString(stderr).toStdString());
-    return parse(QString(stdout).toStdString());
+    return stdout;
+
+}
+
+
+// build the PH object from the expanded content
+PHPtr PHIO::build (PHExpander::Result const& expanded) {
+
+    PHPtr res = make_shared<PH>();
+    res->setInfiniteDefaultRate(expanded.infiniteDefaultRate);
+    res->setDefaultRate(expanded.defaultRate);
+    res->setStochasticityAbsorption(expanded.stochasticityAbsorption);
+
+    for (auto &s : expanded.sorts)
+        res->addSort(s.first, s.second);
+
+    for (auto &a : expanded.actions) {
+        SortPtr target = res->getSort(a.targetSort);
+        res->addAction(	res->getSort(a.hitterSort)->getProcess(a.hitter)
+                    ,	target->getProcess(a.target)
+                    ,	target->getProcess(a.result)
+                    ,	a.infiniteRate, a.rate, a.sa);
+    }
+
+    for (auto &i : expanded.initialState)
+        res->getSort(i.first)->setActiveProcess(i.second);
+
+    return res;
+}
+
+
+// parse file
+PHPtr PHIO::parseFile (string const& path) {
+
+    TRACE_SCOPE("parse file", path);
+
+    // map the file rather than reading it (empty files cannot be mapped)
+    Trace::Scope reading("read");
+    IO::fileLocationCheck(path);
+    QFile file(QString::fromUtf8(path.c_str()));
+    if (!file.open(QIODevice::ReadOnly))
+        throw io_error() << file_info(path);
+    size_t length = file.size();
+    QByteArray buffer;
+    const char* content = (const char*) file.map(0, length);
+    if (content == NULL) {
+        buffer = file.readAll();
+        content = buffer.constData();
+        length = buffer.size();
+    }
+
+    // compressed files (.ph.gz) are inflated from the mapping
+    string decompressed;
+    if (IO::isCompressed(content, length)) {
+        TRACE_SCOPE("decompress");
+        try {
+            decompressed = IO::decompress(content, length);
+        } catch (io_error& x) {
+            x << file_info(path);
+            throw;
+        }
+        content = decompressed.data();
+        length = decompressed.size();
+    }
+    reading.stop();
+
+    return parseCachedContent(content, length, path, false);
+
+}
+
+
+// parse the content of a file, through the cache
+PHPtr PHIO::parseCachedContent (const char* content, size_t length, string const& path, bool store) {
+
+    // unchanged files are loaded from their compiled model
+    PHPtr res;
+    QByteArray key;
+    {
+        TRACE_SCOPE("cache lookup");
+        key = PHCache::key(content, length);
+        res = PHCache::load(key);
+    }
+    if (res)
+        return res;
+
+    try {
+        res = parseContent(content, length);
+    } catch (exception_base& x) {
+        x << file_info(path);
+        throw;
+    }
+    if (store) {
+        TRACE_SCOPE("cache store");
+        PHCache::store(key, res);
+    }
+    return res;
 
 }
 
 
+// parse the content of a PH file
+PHPtr PHIO::parseContent (const char* content, size_t length) {
+
+    // files already in basic form are parsed directly
+    if (isBasicForm(content, length)) {
+        try {
+            TRACE_SCOPE("scan");
+            return parse(content, length);
+        } catch (ph_parse_error&) {
+            // the expander will tell where the error is
+        } catch (ph_error&) {
+            // same for unknown sorts and processes
+        }
+    }
+
+    // otherwise expand macros natively, except GRN which is left to phc when it is available
+    PHExpander::Result expanded;
+    {
+        TRACE_SCOPE("expand");
+        expanded = PHExpander::expand(content, content + length);
+    }
+    if (expanded.grn) {
+        try {
+            QByteArray dump;
+            {
+                TRACE_SCOPE("phc");
+                dump = dumpWithPhc(content, length);
+            }
+            TRACE_SCOPE("scan");
+            return parse(dump.constData(), dump.size());
+        } catch (pint_program_not_found&) {
+            // the native expansion follows the same rules
+        }
+    }
+    return build(expanded);
+
+}
+
+
+// parse the content of a PH file, expanding all its macros natively
+PHPtr PHIO::parseContentNatively (const char* content, size_t length) {
+    TRACE_SCOPE("expand");
+    return build(PHExpander::expand(content, content + length));
+}
+
+
+// parse file using phc to expand macros
+PHPtr PHIO::parseFileWithPhc (string const& path) {
+    QByteArray dump = dumpWithPhc(path);
+    return parse(dump.constData(), dump.size());
+}
+
+
 // can parse the PH file which path is given as parameter?
 bool PHIO::canParseFile (string const& path) {
     try {
@@ -169,9 +655,17 @@ bool PHIO::canParseFile (string const& path) {
 }
 
 
-// write PH file
+// write PH file (compressed if its name ends with .gz)
 void PHIO::writeToFile (string const& path, PHPtr ph) {
-    IO::writeFile(path, ph->toString());
+    TRACE_SCOPE("write PH file", path);
+    IO::writeStream(path, [&] (std::ostream& out) { ph->write(out); });
+}
+
+
+// write DOT file
+void PHIO::writeDotToFile (string const& path, PHPtr ph) {
+    TRACE_SCOPE("write DOT file", path);
+    IO::writeStream(path, [&] (std::ostream& out) { ph->writeDot(out); });
 }
 
 
@@ -180,25 +674,27 @@ void PHIO::exportToPNG(PHPtr ph, QString name) {
 
     // create the image and render it
     // TODO make margins (currently: 4 pixels) configuration variables
-    QImage* image = new QImage(ph->getGraphicsScene()->width()+4, ph->getGraphicsScene()->height()+4, QImage::Format_ARGB32_Premultiplied);
-    QPainter* p = new QPainter();
-    p->begin(image);
-    p->setRenderHint(QPainter::Antialiasing);
-    ph->getGraphicsScene()->render(p);
-    p->end();
+    QImage image(ph->getGraphicsScene()->width()+4, ph->getGraphicsScene()->height()+4, QImage::Format_ARGB32_Premultiplied);
+    QPainter p;
+    p.begin(&image);
+    p.setRenderHint(QPainter::Antialiasing);
+    ph->getGraphicsScene()->render(&p);
+    p.end();
 
     // add .png to the name if necessary
     if (name.indexOf(QString(".png"), 0, Qt::CaseInsensitive) < 0)
         name += ".png";
 
     // save it
-    image->save(name, "PNG");
+    image.save(name, "PNG");
 }
 
 
 // export preferences to XML
 void PHIO::exportXMLMetadata(MainWindow *window, QFile &output){
 
+    TRACE_SCOPE("export XML");
+
     QXmlStreamWriter stream(&output);
 
     Area* area = (Area*)window->getCentraleArea()->currentSubWindow()->widget();
@@ -233,29 +729,31 @@ void PHIO::exportXMLMetadata(MainWindow *window, QFile &output){
     stream.writeEndElement(); // global
 
     stream.writeStartElement("sorts");
+    PHScenePtr scene = myarea->getPHPtr()->getGraphicsScene();
     for (SortPtr &a: myarea->getPHPtr()->getSorts()){
+        GSortPtr gsort = scene->getGSort(a->getId());
         stream.writeStartElement("sort");
         stream.writeAttribute("name", QString::fromStdString(a->getName()));
-        stream.writeAttribute("visible", QString::number(myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->GSort::isVisible()));
+        stream.writeAttribute("visible", QString::number(gsort->GSort::isVisible()));
 
         stream.writeStartElement("pos");
-        stream.writeAttribute("x",QString::number(myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->x()));
-        stream.writeAttribute("y",QString::number(myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->y()));
-        stream.writeAttribute("xcluster",QString::number(myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->getLeftTopCornerPoint()->x()));
-        stream.writeAttribute("ycluster",QString::number(myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->getLeftTopCornerPoint()->y()));
+        stream.writeAttribute("x",QString::number(gsort->x()));
+        stream.writeAttribute("y",QString::number(gsort->y()));
+        stream.writeAttribute("xcluster",QString::number(gsort->getLeftTopCornerPoint()->x()));
+        stream.writeAttribute("ycluster",QString::number(gsort->getLeftTopCornerPoint()->y()));
         stream.writeEndElement(); // pos
 
         stream.writeStartElement("size");
-        stream.writeAttribute("w", QString::number(myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->boundingRect().width()));
-        stream.writeAttribute("h", QString::number(myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->boundingRect().height()));
+        stream.writeAttribute("w", QString::number(gsort->boundingRect().width()));
+        stream.writeAttribute("h", QString::number(gsort->boundingRect().height()));
         stream.writeEndElement(); // size
 
-        stream.writeTextElement("color", myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->getRect()->brush().color().name());
+        stream.writeTextElement("color", gsort->getRect()->brush().color().name());
 
         stream.writeStartElement("label");
-        stream.writeAttribute("text", myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->getText()->toPlainText());
+        stream.writeAttribute("text", gsort->getText()->toPlainText());
 
-        stream.writeTextElement("font", myarea->getPHPtr()->getGraphicsScene()->getGSort(a->getName())->getText()->font().toString());
+        stream.writeTextElement("font", gsort->getText()->font().toString());
 
         stream.writeStartElement("pos");
         stream.writeAttribute("x", "");
@@ -267,7 +765,7 @@ void PHIO::exportXMLMetadata(MainWindow *window, QFile &output){
         stream.writeStartElement("processes");
         stream.writeAttribute("nb", QString::number(a->getProcesses().size()));
 
-        for (ProcessPtr &b : a->getProcesses()){
+        for (const ProcessPtr &b : a->getProcesses()){
             stream.writeStartElement("process");
             stream.writeAttribute("i", QString::number(b->getNumber()));
 
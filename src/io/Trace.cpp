@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include "Trace.h"
+
+
+using std::map;
+using std::vector;
+
+
+// a phase, as recorded
+struct TraceEvent {
+    const char* name;
+    string      detail;
+    qint64      start;
+    qint64      duration;
+    int         thread;
+};
+
+QAtomicInt Trace::enabled(0);
+
+// records and threads are shared by all the threads, hence the mutex
+static QMutex mutex;
+static vector<TraceEvent> events;
+static QHash<Qt::HANDLE, int> threads;
+
+// started when the program is loaded
+static QElapsedTimer clockFromStart (void) {
+    QElapsedTimer t;
+    t.start();
+    return t;
+}
+static const QElapsedTimer startClock = clockFromStart();
+
+
+bool Trace::isEnabled (void) { return enabled == 1; }
+void Trace::setEnabled (bool b) { enabled.fetchAndStoreOrdered(b ? 1 : 0); }
+
+qint64 Trace::now (void) { return startClock.nsecsElapsed() / 1000; }
+
+
+// record a phase, threads are numbered in order of appearance
+void Trace::record (const char* name, qint64 start, const string& detail) {
+    TraceEvent e;
+    e.name = name;
+    e.detail = detail;
+    e.start = start;
+    e.duration = now() - start;
+    QMutexLocker lock(&mutex);
+    Qt::HANDLE thread = QThread::currentThreadId();
+    if (!threads.contains(thread))
+        threads.insert(thread, threads.size() + 1);
+    e.thread = threads.value(thread);
+    events.push_back(e);
+}
+
+void Trace::clear (void) {
+    QMutexLocker lock(&mutex);
+    events.clear();
+}
+
+int Trace::count (void) {
+    QMutexLocker lock(&mutex);
+    return events.size();
+}
+
+
+// JSON string, escaped
+static string quote (const string& s) {
+    string res = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            res += '\\';
+            res += c;
+        } else if ((unsigned char) c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            res += code;
+        } else {
+            res += c;
+        }
+    }
+    return res + "\"";
+}
+
+
+// complete events ("ph": "X"), times in microseconds
+bool Trace::writeChromeTrace (const QString& path) {
+
+    string json = "{\"traceEvents\":[\n";
+    {
+        QMutexLocker lock(&mutex);
+        for (size_t i = 0; i < events.size(); i++) {
+            const TraceEvent& e = events[i];
+            char times[128];
+            snprintf(times, sizeof(times), "\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d",
+                     (long long) e.start, (long long) e.duration, e.thread);
+            json += "{\"name\":" + quote(e.name) + ",\"cat\":\"pappl\",\"ph\":\"X\"," + times;
+            if (!e.detail.empty())
+                json += ",\"args\":{\"detail\":" + quote(e.detail) + "}";
+            json += (i + 1 < events.size()) ? "},\n" : "}\n";
+        }
+    }
+    json += "],\"displayTimeUnit\":\"ms\"}\n";
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(json.data(), json.size()) == (qint64) json.size();
+}
+
+
+// count, total, mean and max by phase
+QString Trace::summary (void) {
+
+    struct Total { int count; qint64 total; qint64 max; };
+    map<string, Total> totals;
+    {
+        QMutexLocker lock(&mutex);
+        for (const TraceEvent& e : events) {
+            Total& t = totals[e.name];
+            t.count++;
+            t.total += e.duration;
+            t.max = std::max(t.max, e.duration);
+        }
+    }
+
+    // longest phases first
+    vector< std::pair<qint64, string> > order;
+    for (auto &t : totals)
+        order.push_back(std::make_pair(-t.second.total, t.first));
+    std::sort(order.begin(), order.end());
+
+    QString res;
+    char line[256];
+    snprintf(line, sizeof(line), "%-28s %8s %12s %12s %12s\n", "phase", "count", "total (ms)", "mean (ms)", "max (ms)");
+    res += line;
+    for (auto &o : order) {
+        const Total& t = totals[o.second];
+        snprintf(line, sizeof(line), "%-28s %8d %12.3f %12.3f %12.3f\n", o.second.c_str(), t.count,
+                 t.total / 1000., t.total / 1000. / t.count, t.max / 1000.);
+        res += line;
+    }
+    return res;
+}
@@ -1,56 +1,61 @@
 #include <iostream>
-#include <boost/lexical_cast.hpp>
+#include <sstream>
 #include "Action.h"
+#include "IO.h"
 
 
-Action::Action (ProcessPtr source_, ProcessPtr target_, ProcessPtr result_, const bool& infiniteRate_, const double& r_, const int& sa_)
-    : source(source_), target(target_), result(result_), infiniteRate(infiniteRate_), r(r_), sa(sa_) {}
+Action::Action (PH* ph_, int index_) : ph(ph_), index(index_) {}
 
 
 // getters
-ProcessPtr Action::getSource() { return source; }
-ProcessPtr Action::getTarget() { return target; }
-ProcessPtr Action::getResult() { return result; }
+int Action::getIndex() { return index; }
+ProcessPtr Action::getSource() { return ph->getProcess(ph->getActionTable().getSources()[index]); }
+ProcessPtr Action::getTarget() { return ph->getProcess(ph->getActionTable().getTargets()[index]); }
+ProcessPtr Action::getResult() { return ph->getProcess(ph->getActionTable().getResults()[index]); }
+bool Action::getInfiniteRate() { return ph->getActionTable().getInfiniteRates()[index]; }
+float Action::getRate() { return ph->getActionTable().getRates()[index]; }
+int Action::getStochasticityAbsorption() { return ph->getActionTable().getStochasticityAbsorptions()[index]; }
 
 
 // output for DOT file
 string Action::toDotString (void) {
-	string res;
-
-    res += 				source->getDotName()
-			+ " -> " + 	target->getDotName()
-			+ ";\n";
-    res += 				target->getDotName()
-			+ " -> " + 	result->getDotName()
-			+ ";\n";
+	std::ostringstream res;
+	writeDot(res);
+	return res.str();
+}
 
-    return res;
+void Action::writeDot (std::ostream& out) {
+	ProcessPtr target = getTarget();
+
+	getSource()->writeDotName(out);
+	out << " -> ";
+	target->writeDotName(out);
+	out << ";\n";
+	target->writeDotName(out);
+	out << " -> ";
+	getResult()->writeDotName(out);
+	out << ";\n";
 }
 
 
 // output for PH file
 string Action::toString (void) {
+	std::ostringstream res;
+	write(res);
+	return res.str();
+}
+
+void Action::write (std::ostream& out) {
+
+	ProcessPtr source = getSource();
+	ProcessPtr target = getTarget();
 
-	return 		source->getSort()->getName()
-			+	" "
-			+	boost::lexical_cast<string>(source->getNumber())
-			+ 	" -> " 
-			+ 	target->getSort()->getName()
-			+	" "
-			+	 boost::lexical_cast<string>(target->getNumber())
-			+	" "
-			+ 	 boost::lexical_cast<string>(result->getNumber())
-			+	" @"
-			+	(infiniteRate ? 
-					"Inf" 
-					:
-					(r == (int) r) ? 
-						boost::lexical_cast<string>(r) + "."
-						:
-						boost::lexical_cast<string>(r)
-				)						
-			+	"~"
-			+	 boost::lexical_cast<string>(sa)
-			+	"\n"
-			;
+	out << source->getSort()->getName() << ' ' << source->getNumber()
+		<< " -> " << target->getSort()->getName() << ' ' << target->getNumber()
+		<< ' ' << getResult()->getNumber() << " @";
+	if (getInfiniteRate())
+		out << "Inf";
+	else
+		IO::writeDecimal(out, getRate(), 9);
+	out << '~' << getStochasticityAbsorption() << '\n';
 }
@@ -0,0 +1,79 @@
+#include "Exceptions.h"
+#include "ActionTable.h"
+
+
+// add an action as a new row
+int ActionTable::add (int source, int target, int result, bool infiniteRate, float rate, int sa) {
+    sources.push_back(source);
+    targets.push_back(target);
+    results.push_back(result);
+    infiniteRates.push_back(infiniteRate);
+    rates.push_back(rate);
+    stochasticityAbsorptions.push_back(sa);
+    return sources.size() - 1;
+}
+
+void ActionTable::reserve (int n) {
+    sources.reserve(n);
+    targets.reserve(n);
+    results.reserve(n);
+    infiniteRates.reserve(n);
+    rates.reserve(n);
+    stochasticityAbsorptions.reserve(n);
+}
+
+void ActionTable::assign (int n, const int32_t* sources_, const int32_t* targets_, const int32_t* results_,
+                          const uint8_t* infiniteRates_, const float* rates_, const int32_t* sa_) {
+    sources.assign(sources_, sources_ + n);
+    targets.assign(targets_, targets_ + n);
+    results.assign(results_, results_ + n);
+    infiniteRates.assign(infiniteRates_, infiniteRates_ + n);
+    rates.assign(rates_, rates_ + n);
+    stochasticityAbsorptions.assign(sa_, sa_ + n);
+}
+
+
+// getters
+int ActionTable::size (void) const { return sources.size(); }
+const vector<int32_t>& ActionTable::getSources (void) const { return sources; }
+const vector<int32_t>& ActionTable::getTargets (void) const { return targets; }
+const vector<int32_t>& ActionTable::getResults (void) const { return results; }
+const vector<uint8_t>& ActionTable::getInfiniteRates (void) const { return infiniteRates; }
+const vector<float>& ActionTable::getRates (void) const { return rates; }
+const vector<int32_t>& ActionTable::getStochasticityAbsorptions (void) const { return stochasticityAbsorptions; }
+
+
+// counting sort of the actions by key
+void ActionIndex::build (const vector<int32_t>& keys, int keyCount) {
+    build(keys, vector<int32_t>(keys.size(), -1), keyCount);
+}
+
+void ActionIndex::build (const vector<int32_t>& keys, const vector<int32_t>& otherKeys, int keyCount) {
+
+    // count the actions of each key
+    offsets.assign(keyCount + 1, 0);
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] >= 0)
+            offsets[keys[i] + 1]++;
+        if (otherKeys[i] >= 0 && otherKeys[i] != keys[i])
+            offsets[otherKeys[i] + 1]++;
+    }
+    for (int k = 0; k < keyCount; k++)
+        offsets[k + 1] += offsets[k];
+
+    // fill, in action order
+    actions.resize(offsets[keyCount]);
+    vector<int32_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] >= 0)
+            actions[next[keys[i]]++] = i;
+        if (otherKeys[i] >= 0 && otherKeys[i] != keys[i])
+            actions[next[otherKeys[i]]++] = i;
+    }
+}
+
+ActionRange ActionIndex::get (int key) const {
+    if (key < 0 || key + 1 >= (int) offsets.size())
+        throw process_not_found() << process_info(key);
+    return ActionRange(actions.data() + offsets[key], actions.data() + offsets[key + 1]);
+}
@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <atomic>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include "Fixpoints.h"
+#include "Trace.h"
+
+
+Fixpoints::Options::Options (void) : threads(0), maxFixpoints(1 << 20) {}
+
+Fixpoints::Result::Result (void) : fixpoints(0), nodes(0), complete(false), elapsed(0) {}
+
+
+// number of fixpoints a worker keeps before giving them
+static const size_t batchSize = 256;
+
+// subproblems by thread, so that the threads stay busy when some subproblems are much larger
+static const size_t splitFactor = 8;
+
+
+Fixpoints::Fixpoints (PH& ph) {
+
+    int n = ph.countSorts();
+    offset.resize(n + 1);
+    for (int s = 0; s < n; s++)
+        offset[s + 1] = offset[s] + ph.getSort(s)->countProcesses();
+    sortOf.resize(offset[n]);
+    for (int s = 0; s < n; s++)
+        std::fill(sortOf.begin() + offset[s], sortOf.begin() + offset[s + 1], s);
+
+    // each action forbids its hitter and its target together, self-loops (result = target) left out
+    alone.assign(offset[n], false);
+    vector< vector<int> > pairs(offset[n]);
+    const ActionTable& table = ph.getActionTable();
+    for (int a = 0; a < table.size(); a++) {
+        ProcessPtr hitter = ph.getProcess(table.getSources()[a]);
+        ProcessPtr target = ph.getProcess(table.getTargets()[a]);
+        if (ph.getProcess(table.getResults()[a]) == target)
+            continue;
+        int h = offset[hitter->getSort()->getId()] + hitter->getNumber();
+        int t = offset[target->getSort()->getId()] + target->getNumber();
+        if (h == t)
+            alone[t] = true;
+        else if (sortOf[h] != sortOf[t]) {
+            pairs[h].push_back(t);
+            pairs[t].push_back(h);
+        }
+    }
+    first.assign(offset[n] + 1, 0);
+    for (int p = 0; p < offset[n]; p++) {
+        std::sort(pairs[p].begin(), pairs[p].end());
+        pairs[p].erase(std::unique(pairs[p].begin(), pairs[p].end()), pairs[p].end());
+        first[p + 1] = first[p] + pairs[p].size();
+        forbidden.insert(forbidden.end(), pairs[p].begin(), pairs[p].end());
+    }
+}
+
+
+bool Fixpoints::choose (Node& node, int process, vector<int>& queue) {
+    int s = sortOf[process];
+    if (!(node.left[process / 64] >> (process % 64) & 1))
+        return false;
+    for (int p = offset[s]; p < offset[s + 1]; p++)
+        if (p != process)
+            node.left[p / 64] &= ~((uint64_t) 1 << (p % 64));
+    node.count[s] = 1;
+
+    // the processes forbidden with the ones chosen are removed, until no sort is left with only one
+    queue.assign(1, process);
+    while (!queue.empty()) {
+        int p = queue.back();
+        queue.pop_back();
+        for (int k = first[p]; k < first[p + 1]; k++) {
+            int q = forbidden[k];
+            uint64_t& word = node.left[q / 64];
+            uint64_t bit = (uint64_t) 1 << (q % 64);
+            if (!(word & bit))
+                continue;
+            word &= ~bit;
+            int t = sortOf[q];
+            if (--node.count[t] == 0)
+                return false;
+            if (node.count[t] == 1)
+                for (int r = offset[t]; r < offset[t + 1]; r++)
+                    if (node.left[r / 64] >> (r % 64) & 1)
+                        queue.push_back(r);
+        }
+    }
+    return true;
+}
+
+
+int Fixpoints::nextSort (const Node& node) {
+    int res = -1;
+    for (int s = 0; s < (int) node.count.size(); s++)
+        if (node.count[s] > 1 && (res < 0 || node.count[s] < node.count[res]))
+            res = s;
+    return res;
+}
+
+
+Fixpoints::State Fixpoints::state (const Node& node) {
+    State res(node.count.size());
+    for (int s = 0; s < (int) res.size(); s++)
+        for (int p = offset[s]; p < offset[s + 1]; p++)
+            if (node.left[p / 64] >> (p % 64) & 1)
+                res[s] = p - offset[s];
+    return res;
+}
+
+
+// what the workers share
+struct FixpointsSearch {
+    Fixpoints* f;
+    Fixpoints::Found found;
+    std::function<bool ()> cancelled;
+    size_t maxFixpoints;
+    const vector<Fixpoints::Node>* subproblems;
+    QMutex mutex;
+    std::atomic<size_t> cursor;
+    std::atomic<size_t> fixpoints;
+    std::atomic<size_t> nodes;
+    std::atomic<bool> stop;
+};
+
+
+// searches the subproblems in turn, depth first
+class FixpointsWorker : public QRunnable {
+
+    public:
+        FixpointsWorker (FixpointsSearch* s_) : s(s_), nodes(0) {}
+
+        void run () {
+            for (;;) {
+                size_t i = s->cursor.fetch_add(1);
+                if (i >= s->subproblems->size() || s->stop.load(std::memory_order_relaxed))
+                    break;
+                search((*s->subproblems)[i]);
+                give();
+            }
+            give();
+            s->nodes += nodes;
+        }
+
+    private:
+
+        void search (const Fixpoints::Node& node) {
+            if (s->stop.load(std::memory_order_relaxed))
+                return;
+            Fixpoints& f = *s->f;
+            int sort = f.nextSort(node);
+            if (sort < 0) {
+                if (s->fixpoints.fetch_add(1) >= s->maxFixpoints) {
+                    s->stop = true;
+                    return;
+                }
+                batch.push_back(f.state(node));
+                if (batch.size() >= batchSize)
+                    give();
+                return;
+            }
+            for (int p = f.offset[sort]; p < f.offset[sort + 1]; p++) {
+                if (!(node.left[p / 64] >> (p % 64) & 1))
+                    continue;
+                // a choice of a process, counted as in the split phase
+                if (++nodes % 1024 == 0 && s->cancelled && s->cancelled()) {
+                    s->stop = true;
+                    return;
+                }
+                Fixpoints::Node child = node;
+                if (f.choose(child, p, queue))
+                    search(child);
+            }
+        }
+
+        // the fixpoints found so far, to the caller
+        void give () {
+            if (batch.empty())
+                return;
+            {
+                QMutexLocker lock(&s->mutex);
+                s->found(batch);
+            }
+            batch.clear();
+        }
+
+        FixpointsSearch* s;
+        size_t nodes;
+        vector<int> queue;
+        vector<Fixpoints::State> batch;
+};
+
+
+Fixpoints::Result Fixpoints::run (Found found, const Options& options, std::function<bool ()> cancelled) {
+
+    TRACE_SCOPE("fixpoints");
+    qint64 start = Trace::now();
+    int threads = options.threads > 0 ? options.threads : QThread::idealThreadCount();
+    Result res;
+
+    // the processes which hit themselves are removed first, then the ones forbidden with the sorts left with one
+    int n = offset.size() - 1;
+    Node root;
+    root.left.assign((offset[n] + 63) / 64, 0);
+    root.count.assign(n, 0);
+    for (int p = 0; p < offset[n]; p++)
+        if (!alone[p]) {
+            root.left[p / 64] |= (uint64_t) 1 << (p % 64);
+            root.count[sortOf[p]]++;
+        }
+    vector<int> queue;
+    bool possible = std::find(root.count.begin(), root.count.end(), 0) == root.count.end();
+    for (int s = 0; s < n && possible; s++)
+        if (root.count[s] == 1)
+            for (int p = offset[s]; p < offset[s + 1] && possible; p++)
+                if (root.left[p / 64] >> (p % 64) & 1)
+                    possible = choose(root, p, queue);
+
+    // the first levels, until there are enough subproblems for the threads
+    vector<Node> subproblems;
+    if (possible)
+        subproblems.push_back(root);
+    while (!subproblems.empty() && subproblems.size() < splitFactor * threads) {
+        vector<Node> next;
+        bool split = false;
+        for (const Node& node : subproblems) {
+            int s = nextSort(node);
+            if (s < 0) {
+                next.push_back(node);
+                continue;
+            }
+            split = true;
+            for (int p = offset[s]; p < offset[s + 1]; p++) {
+                if (!(node.left[p / 64] >> (p % 64) & 1))
+                    continue;
+                Node child = node;
+                res.nodes++;
+                if (choose(child, p, queue))
+                    next.push_back(child);
+            }
+        }
+        subproblems.swap(next);
+        if (!split)
+            break;
+    }
+
+    FixpointsSearch search;
+    search.f = this;
+    search.found = found;
+    search.cancelled = cancelled;
+    search.maxFixpoints = options.maxFixpoints;
+    search.subproblems = &subproblems;
+    search.cursor = 0;
+    search.fixpoints = 0;
+    search.nodes = 0;
+    search.stop = false;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    int workers = std::min<size_t>(threads, subproblems.size());
+    for (int t = 0; t < workers; t++)
+        pool.start(new FixpointsWorker(&search));
+    pool.waitForDone();
+
+    res.fixpoints = std::min(search.fixpoints.load(), options.maxFixpoints);
+    res.nodes += search.nodes;
+    res.complete = !search.stop;
+    res.elapsed = (Trace::now() - start) / 1000;
+    return res;
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <functional>
+#include "LocalCausality.h"
+#include "Trace.h"
+
+
+LocalCausality::Result::Result (void) : answer(Reachability::Unknown), elapsed(0) {}
+
+
+// solutions kept by objective, and transitions tried while looking for them
+static const size_t maxSolutions = 16;
+static const int maxExpansions = 4096;
+
+// solutions tried by query, before the answer is unknown
+static const int maxTries = 1 << 16;
+
+
+LocalCausality::LocalCausality (PH& ph) {
+
+    int n = ph.countSorts();
+    offset.resize(n + 1);
+    initial.resize(n);
+    for (int s = 0; s < n; s++) {
+        offset[s + 1] = offset[s] + ph.getSort(s)->countProcesses();
+        initial[s] = ph.getSort(s)->getActiveProcess()->getNumber();
+    }
+
+    // transitions by target process, leaving out self-loops (result = target)
+    // and actions which can never be played (hitter and target different processes of a sort)
+    const ActionTable& table = ph.getActionTable();
+    vector<Transition> all;
+    for (int a = 0; a < table.size(); a++) {
+        ProcessPtr hitter = ph.getProcess(table.getSources()[a]);
+        ProcessPtr target = ph.getProcess(table.getTargets()[a]);
+        ProcessPtr result = ph.getProcess(table.getResults()[a]);
+        if (result == target || (hitter->getSort() == target->getSort() && hitter != target))
+            continue;
+        Transition t;
+        t.sort = target->getSort()->getId();
+        t.target = target->getNumber();
+        t.result = result->getNumber();
+        t.hitterSort = hitter->getSort()->getId();
+        t.hitter = hitter->getNumber();
+        t.action = a;
+        all.push_back(t);
+    }
+    first.assign(offset[n] + 1, 0);
+    for (const Transition& t : all)
+        first[offset[t.sort] + t.target + 1]++;
+    for (int p = 0; p < offset[n]; p++)
+        first[p + 1] += first[p];
+    vector<int> next(first.begin(), first.end() - 1);
+    transitions.resize(all.size());
+    vector< vector<int> > byHitter(offset[n]);
+    for (const Transition& t : all) {
+        int k = next[offset[t.sort] + t.target]++;
+        transitions[k] = t;
+        byHitter[offset[t.hitterSort] + t.hitter].push_back(k);
+    }
+
+    // the processes which may be reached, each new one enabling the transitions it is the target or the hitter of
+    possible.assign(offset[n], false);
+    vector<int> work;
+    for (int s = 0; s < n; s++) {
+        possible[offset[s] + initial[s]] = true;
+        work.push_back(offset[s] + initial[s]);
+    }
+    while (!work.empty()) {
+        int p = work.back();
+        work.pop_back();
+        vector<int> enabled = byHitter[p];
+        for (int k = first[p]; k < first[p + 1]; k++)
+            enabled.push_back(k);
+        for (int k : enabled) {
+            const Transition& t = transitions[k];
+            int result = offset[t.sort] + t.result;
+            if (       possible[offset[t.sort] + t.target] && possible[offset[t.hitterSort] + t.hitter]
+                    && !possible[result]) {
+                possible[result] = true;
+                work.push_back(result);
+            }
+        }
+    }
+}
+
+
+bool LocalCausality::isPossible (int sort, int process) {
+    return possible[offset[sort] + process];
+}
+
+int LocalCausality::countObjectives (void) {
+    QMutexLocker lock(&mutex);
+    return solutions.size();
+}
+
+
+const vector<LocalCausality::Solution>& LocalCausality::solve (const Objective& objective) {
+    {
+        QMutexLocker lock(&mutex);
+        std::map<Objective, vector<Solution> >::const_iterator found = solutions.find(objective);
+        if (found != solutions.end())
+            return found->second;
+    }
+
+    // the paths without loop, by length, among the transitions whose hitter may be reached
+    int sort = objective.first;
+    int from = objective.second.first;
+    int to = objective.second.second;
+    vector<Solution> res;
+    if (from == to)
+        res.push_back(Solution());
+    vector<bool> visited(offset[sort + 1] - offset[sort], false);
+    Solution path;
+    int expansions = 0;
+    size_t length = 0;
+    std::function<void (int)> extend = [&] (int p) {
+        if (path.size() == length) {
+            if (p == to)
+                res.push_back(path);
+            return;
+        }
+        if (p == to)
+            return;
+        visited[p] = true;
+        for (int k = first[offset[sort] + p]; k < first[offset[sort] + p + 1]; k++) {
+            if (res.size() >= maxSolutions || ++expansions > maxExpansions)
+                break;
+            const Transition& t = transitions[k];
+            if (visited[t.result] || !possible[offset[t.hitterSort] + t.hitter])
+                continue;
+            path.push_back(k);
+            extend(t.result);
+            path.pop_back();
+        }
+        visited[p] = false;
+    };
+    if (from != to)
+        for (length = 1; length < visited.size() && res.size() < maxSolutions && expansions <= maxExpansions; length++)
+            extend(from);
+
+    // another thread may have solved it meanwhile
+    QMutexLocker lock(&mutex);
+    return solutions.insert(std::make_pair(objective, res)).first->second;
+}
+
+
+bool LocalCausality::reach (vector<int>& state, int sort, int process, vector<int>& trace, vector<Objective>& stack, int& budget) {
+    if (state[sort] == process)
+        return true;
+    Objective objective(sort, std::make_pair(state[sort], process));
+    if (std::find(stack.begin(), stack.end(), objective) != stack.end())
+        return false;
+
+    stack.push_back(objective);
+    for (const Solution& solution : solve(objective)) {
+        if (--budget < 0)
+            break;
+        vector<int> s = state;
+        size_t played = trace.size();
+        bool ok = true;
+        for (int k : solution) {
+            const Transition& t = transitions[k];
+            if (t.hitterSort != sort && !reach(s, t.hitterSort, t.hitter, trace, stack, budget)) {
+                ok = false;
+                break;
+            }
+            // reaching the hitter may have moved the sort, or the hitter when it was already active
+            if (s[sort] != t.target || s[t.hitterSort] != t.hitter) {
+                ok = false;
+                break;
+            }
+            s[sort] = t.result;
+            trace.push_back(t.action);
+        }
+        if (ok) {
+            state = s;
+            stack.pop_back();
+            return true;
+        }
+        trace.resize(played);
+    }
+    stack.pop_back();
+    return false;
+}
+
+
+LocalCausality::Result LocalCausality::run (const vector<Reachability::Requirement>& goal) {
+
+    TRACE_SCOPE("local causality");
+    qint64 start = Trace::now();
+    Result res;
+
+    // a process never active, or two processes of a sort
+    for (const Reachability::Requirement& g : goal) {
+        bool impossible = !isPossible(g.first, g.second);
+        for (const Reachability::Requirement& h : goal)
+            impossible |= h.first == g.first && h.second != g.second;
+        if (impossible) {
+            res.answer = Reachability::Unreachable;
+            res.elapsed = Trace::now() - start;
+            return res;
+        }
+    }
+
+    // the processes reached in turn, in both orders
+    int budget = maxTries;
+    vector<Reachability::Requirement> order = goal;
+    for (int attempt = 0; attempt < 2 && res.answer == Reachability::Unknown && budget > 0; attempt++) {
+        vector<int> state = initial;
+        vector<int> trace;
+        bool ok = true;
+        for (const Reachability::Requirement& g : order) {
+            vector<Objective> stack;
+            if (!reach(state, g.first, g.second, trace, stack, budget)) {
+                ok = false;
+                break;
+            }
+        }
+        for (const Reachability::Requirement& g : goal)
+            ok = ok && state[g.first] == g.second;
+        if (ok) {
+            res.answer = Reachability::Reachable;
+            res.witness = trace;
+        }
+        std::reverse(order.begin(), order.end());
+    }
+    res.elapsed = Trace::now() - start;
+    return res;
+}
@@ -1,11 +1,16 @@
-#include <boost/algorithm/string/join.hpp>
 #include <boost/lexical_cast.hpp>
 #include <iostream>
+#include <sstream>
 #include "Exceptions.h"
+#include "IO.h"
 #include "PH.h"
+#include "PHDiff.h"
 #include "MainWindow.h"
 #include <GVSkeletonGraph.h>
 #include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
+#include "Trace.h"
 
 
 #define DEFAULT_INFINITE_DEFAULT_RATE true
@@ -20,13 +25,39 @@ PH::PH () {
 	infinite_default_rate 		= DEFAULT_INFINITE_DEFAULT_RATE;
 	default_rate 				= DEFAULT_RATE;
 	stochasticity_absorption 	= DEFAULT_STOCHASTICITY_ABSORPTION;
+
+	indexed = false;
 }
 
 
 // trigger the rendering in the Scene
 void PH::render () {
+    render(layoutSkeleton());
+}
+
+void PH::render (const QList<GVNode>& layout) {
     if (scene.use_count() == 0) scene = make_shared<PHScene>(this);
-    scene->drawFromSkeleton();
+    scene->drawFromSkeleton(layout);
+}
+
+void PH::render (PH& previous, const PHDiff& diff) {
+    if (previous.scene.use_count() == 0) {
+        render();
+        return;
+    }
+    scene = previous.scene;
+    previous.scene.reset();
+    scene->patch(this, diff, diff.addedSorts.empty() ? QList<GVNode>() : layoutSkeleton());
+}
+
+// graphviz calls from the worker threads and the GUI thread, one at a time
+static QMutex graphvizMutex;
+
+QList<GVNode> PH::layoutSkeleton () {
+    Trace::Scope waiting("wait for graphviz");
+    QMutexLocker lock(&graphvizMutex);
+    waiting.stop();
+    return createSkeletonGraph()->nodes();
 }
 
 // get graphics scene for display
@@ -38,7 +69,7 @@ PHScenePtr PH::getGraphicsScene() {
 
 // control headers
 int PH::getStochasticityAbsorption () 			{ return stochasticity_absorption; }
-void PH::setStochasticityAbsorption (int sa) 	{ stochasticity_absorption = sa; std::cerr << "set " << sa << std::endl; }
+void PH::setStochasticityAbsorption (int sa) 	{ stochasticity_absorption = sa; }
 bool PH::getInfiniteDefaultRate () 				{ return infinite_default_rate; }
 void PH::setInfiniteDefaultRate (bool b) 		{ infinite_default_rate = b; }
 double PH::getDefaultRate () 		{ return default_rate; }
@@ -46,8 +77,37 @@ void PH::setDefaultRate (double r) 	{ default_rate = r; }
 
 
 // add data: Sorts and Actions
-void PH::addSort (SortPtr s) { sorts.insert(SortEntry(s->getName(), s)); }
-void PH::addAction (ActionPtr a) { actions.push_back(a); }
+SortPtr PH::addSort (const string& name, int lastProcess) {
+	map<string, SortPtr>::iterator f = sorts.find(name);
+	if (f != sorts.end())
+		return f->second;
+	if (lastProcess < 1)
+		throw process_required();
+
+    // create the Sort and its Processes in place
+	sortArena.push_back(Sort(name));
+	SortPtr s = &sortArena.back();
+	for (int i = 0; i <= lastProcess; i++) {
+		processArena.push_back(Process(s, i));
+		s->addProcess(&processArena.back());
+	}
+	s->setActiveProcess(0);
+	sorts.insert(SortEntry(name, s));
+	indexed = false;
+
+    // dense identifiers, in order of addition
+	s->setId(sortsById.size());
+	sortsById.push_back(s);
+	for (const ProcessPtr &p : s->getProcesses()) {
+		p->setId(processesById.size());
+		processesById.push_back(p);
+	}
+	return s;
+}
+int PH::addAction (ProcessPtr source, ProcessPtr target, ProcessPtr result, bool infiniteRate, double rate, int sa) {
+	indexed = false;
+	return actions.add(source->getId(), target->getId(), result->getId(), infiniteRate, rate, sa);
+}
 
 
 // retrieve a Sort by name
@@ -59,38 +119,85 @@ SortPtr PH::getSort (const string& s) {
 }
 
 
-// retrieve all Sorts in a std::list
-list<SortPtr> PH::getSorts(void) {
-	list<SortPtr> res;
-	for (auto &s : sorts)		
-		res.push_back(s.second);
-	return res;
+// retrieve a Sort, or a Process, by its identifier
+SortPtr PH::getSort (int id) {
+	if (id < 0 || id >= (int) sortsById.size())
+		throw sort_not_found() << sort_info(boost::lexical_cast<string>(id));
+	return sortsById[id];
+}
+
+ProcessPtr PH::getProcess (int id) {
+	if (id < 0 || id >= (int) processesById.size())
+		throw process_not_found() << process_info(id);
+	return processesById[id];
+}
+
+int PH::countSorts (void) { return sortsById.size(); }
+int PH::countProcesses (void) { return processesById.size(); }
+
+
+// iterate over all Sorts, in place
+SortRange PH::getSorts(void) { return SortRange(sorts); }
+
+
+// all Processes, in place
+const vector<ProcessPtr>& PH::getProcesses(void) { return processesById; }
+
+
+// retrieve Actions
+Action PH::getAction (int index) { return Action(this, index); }
+int PH::countActions (void) { return actions.size(); }
+const ActionTable& PH::getActionTable (void) { return actions; }
+
+void PH::setActionTable (const ActionTable& table) {
+	actions = table;
+	indexed = false;
 }
 
 
-// retrieve all Processes in a std::list
-list<ProcessPtr> PH::getProcesses(void) {
-	list<ProcessPtr> res;
-	for (auto &s : sorts)
-		for (auto &p : s.second->getProcesses())
-			res.push_back(p);
-	return res;
+// (re)build the indexes of the Actions
+void PH::index (void) {
+	if (indexed)
+		return;
+
+	actionsBySource.build(actions.getSources(), processesById.size());
+	actionsByTarget.build(actions.getTargets(), processesById.size());
+	actionsByResult.build(actions.getResults(), processesById.size());
+
+    // hitter and target sorts (the result is in the target sort)
+	vector<int32_t> sourceSorts, targetSorts;
+	sourceSorts.reserve(actions.size());
+	targetSorts.reserve(actions.size());
+	for (int i = 0; i < actions.size(); i++) {
+		sourceSorts.push_back(processesById[actions.getSources()[i]]->getSort()->getId());
+		targetSorts.push_back(processesById[actions.getTargets()[i]]->getSort()->getId());
+	}
+	actionsBySort.build(sourceSorts, targetSorts, sortsById.size());
+
+	indexed = true;
 }
 
 
-// retrieve the list of Actions
-list<ActionPtr> PH::getActions(void) { return actions; }
+// retrieve Actions by Process or by Sort
+ActionRange PH::getActionsBySource (int process) { index(); return actionsBySource.get(process); }
+ActionRange PH::getActionsByTarget (int process) { index(); return actionsByTarget.get(process); }
+ActionRange PH::getActionsByResult (int process) { index(); return actionsByResult.get(process); }
+
+ActionRange PH::getActionsBySort (int sort) {
+	getSort(sort);
+	index();
+	return actionsBySort.get(sort);
+}
 
 // build the skeleton graph of the ph model
 GVSkeletonGraphPtr PH::createSkeletonGraph(void){
+	TRACE_SCOPE("skeleton graph");
 	GVSkeletonGraphPtr gSkeleton = make_shared<GVSkeletonGraph>(QString("Skeleton Graph"));
 	QString sortName;
-    vector<ProcessPtr> listProcess;
     int nbProcess;
 	for(auto &e : sorts){
 		sortName = makeSkeletonNodeName(e.second->getName());
-		listProcess = e.second->getProcesses();
-        nbProcess = listProcess.size();
+        nbProcess = e.second->countProcesses();
         int height = (nbProcess+1)*(GProcess::sizeDefault+2*GSort::marginDefault);
         int width = height; // modified to get less "vertical" graphs
 		gSkeleton->addNode(sortName);
@@ -98,9 +205,9 @@ GVSkeletonGraphPtr PH::createSkeletonGraph(void){
 		gSkeleton->setGraphObjectAttributes(gSkeleton->getNode(sortName),"fixedsize","true");
 	}
 	
-	for (ActionPtr &a : actions){
-		QString sourceName = makeSkeletonNodeName(a->getSource()->getSort()->getName());
-		QString targetName = makeSkeletonNodeName(a->getTarget()->getSort()->getName());
+	for (int i = 0; i < actions.size(); i++){
+		QString sourceName = makeSkeletonNodeName(processesById[actions.getSources()[i]]->getSort()->getName());
+		QString targetName = makeSkeletonNodeName(processesById[actions.getTargets()[i]]->getSort()->getName());
 		if(!gSkeleton->connectionExists(sourceName,targetName)&&(QString::compare(sourceName,targetName)!=0)){
 			gSkeleton->addEdge(sourceName,targetName);
 		}
@@ -113,59 +220,69 @@ GVSkeletonGraphPtr PH::createSkeletonGraph(void){
 
 // output for DOT file
 string PH::toDotString (void) {
+	std::ostringstream res;
+	writeDot(res);
+	return res.str();
+}
+
+void PH::writeDot (std::ostream& out) {
 
-	string res;
-	res += "digraph G {\n";
-	res += "node [style=filled,color=lightgrey]\n";
-   // res += "edge [samehead]\n";
+	out << "digraph G {\n";
+	out << "node [style=filled,color=lightgrey]\n";
+   // out << "edge [samehead]\n";
 
     // output Sorts
-	res += "\n\n";
-	for (auto &e : sorts)
-		res += e.second->toDotString() + "\n";
+	out << "\n\n";
+	for (auto &e : sorts) {
+		e.second->writeDot(out);
+		out << '\n';
+	}
 
     // output Actions
-	res += "\n\n";
-	for (ActionPtr &a : actions)
-		res += a->toDotString() + "\n";
-	res += "}\n";
-
-    return res;
+	out << "\n\n";
+	for (int i = 0; i < actions.size(); i++) {
+		getAction(i).writeDot(out);
+		out << '\n';
+	}
+	out << "}\n";
 }
 
 
 // output for PH file
 string PH::toString (void) {
+	std::ostringstream res;
+	write(res);
+	return res.str();
+}
 
-    string res;
+void PH::write (std::ostream& out) {
 
     // output headers
-	res += "directive default_rate " + (infinite_default_rate ? "Inf" : 
-		(default_rate == (int) default_rate) ?
-			boost::lexical_cast<string>(default_rate) + "."
-		:	boost::lexical_cast<string>(default_rate)
-	) + "\n";
-    res += "directive stochasticity_absorption " + boost::lexical_cast<string>(stochasticity_absorption) + "\n";
+	out << "directive default_rate ";
+	if (infinite_default_rate)
+		out << "Inf";
+	else
+		IO::writeDecimal(out, default_rate, 17);
+	out << "\ndirective stochasticity_absorption " << stochasticity_absorption << '\n';
 
     // output Sorts
 	for (auto &e : sorts)
-		res += e.second->toString();
-	res += "\n";
+		e.second->write(out);
+	out << '\n';
 
     // output actions
-	for (ActionPtr &a : actions)
-		res += a->toString();
-	res += "\n";
+	for (int i = 0; i < actions.size(); i++)
+		getAction(i).write(out);
+	out << '\n';
 
     // output initial state
 	if (!sorts.empty()) {
-		res += "initial_state ";
-		list<string> l;
-		for (auto &e : sorts)
-			l.push_back(e.second->getName() + " " + boost::lexical_cast<string>(e.second->getActiveProcess()->getNumber()));
-		res += boost::algorithm::join(l, ", ");
+		out << "initial_state ";
+		bool first = true;
+		for (auto &e : sorts) {
+			out << (first ? "" : ", ") << e.second->getName() << ' ' << e.second->getActiveProcess()->getNumber();
+			first = false;
+		}
 	}
-	res += "\n";
-
-	return res;
+	out << '\n';
 }
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <sstream>
+#include <utility>
+#include "PHDiff.h"
+
+
+// an action, sorts being given by their identifier in the previous version
+struct ActionKey {
+    int hitterSort, hitter, targetSort, target, result;
+    int index;
+
+    bool operator< (const ActionKey& other) const {
+        if (hitterSort != other.hitterSort) return hitterSort < other.hitterSort;
+        if (hitter != other.hitter)         return hitter < other.hitter;
+        if (targetSort != other.targetSort) return targetSort < other.targetSort;
+        if (target != other.target)         return target < other.target;
+        return result < other.result;
+    }
+};
+
+
+// keys of the actions of ph, sorted, sort identifiers being translated by sortIds (-1 for a new sort)
+static vector<ActionKey> actionKeys (PH& ph, const vector<int>& sortIds) {
+    const ActionTable& table = ph.getActionTable();
+    vector<ActionKey> res;
+    res.reserve(table.size());
+    for (int i = 0; i < table.size(); i++) {
+        ProcessPtr hitter = ph.getProcess(table.getSources()[i]);
+        ProcessPtr target = ph.getProcess(table.getTargets()[i]);
+        ActionKey k;
+        k.hitterSort    = sortIds[hitter->getSort()->getId()];
+        k.hitter        = hitter->getNumber();
+        k.targetSort    = sortIds[target->getSort()->getId()];
+        k.target        = target->getNumber();
+        k.result        = ph.getProcess(table.getResults()[i])->getNumber();
+        k.index         = i;
+        res.push_back(k);
+    }
+    std::stable_sort(res.begin(), res.end());
+    return res;
+}
+
+
+// pairs of sorts hitting each other, sorted
+static vector< std::pair<int, int> > skeletonEdges (const vector<ActionKey>& keys) {
+    vector< std::pair<int, int> > res;
+    for (const ActionKey &k : keys)
+        if (k.hitterSort != k.targetSort)
+            res.push_back(std::make_pair(k.hitterSort, k.targetSort));
+    std::sort(res.begin(), res.end());
+    res.erase(std::unique(res.begin(), res.end()), res.end());
+    return res;
+}
+
+
+PHDiff::PHDiff (PH& before, PH& after)
+    : addedActions(0), removedActions(0), changedActions(0)
+    , headersChanged(false), initialStateChanged(false), skeletonChanged(false) {
+
+    headersChanged =    before.getInfiniteDefaultRate() != after.getInfiniteDefaultRate()
+                    ||  before.getDefaultRate() != after.getDefaultRate()
+                    ||  before.getStochasticityAbsorption() != after.getStochasticityAbsorption();
+
+    // sorts, matched by name (both lists are sorted by name)
+    vector<SortPtr> beforeSorts, afterSorts;
+    for (SortPtr &s : before.getSorts())
+        beforeSorts.push_back(s);
+    for (SortPtr &s : after.getSorts())
+        afterSorts.push_back(s);
+
+    vector<int> beforeIds(before.countSorts());
+    for (size_t k = 0; k < beforeIds.size(); k++)
+        beforeIds[k] = k;
+    vector<int> afterIds(after.countSorts(), -1);
+
+    size_t i = 0, j = 0;
+    while (i < beforeSorts.size() || j < afterSorts.size()) {
+        if (j == afterSorts.size() || (i < beforeSorts.size() && beforeSorts[i]->getName() < afterSorts[j]->getName())) {
+            removedSorts.push_back(beforeSorts[i++]->getName());
+        } else if (i == beforeSorts.size() || afterSorts[j]->getName() < beforeSorts[i]->getName()) {
+            addedSorts.push_back(afterSorts[j++]->getName());
+        } else {
+            SortPtr b = beforeSorts[i++], a = afterSorts[j++];
+            afterIds[a->getId()] = b->getId();
+            if (a->countProcesses() != b->countProcesses())
+                resizedSorts.push_back(a->getName());
+            if (a->getActiveProcess()->getNumber() != b->getActiveProcess()->getNumber())
+                initialStateChanged = true;
+        }
+    }
+
+    // actions, matched in order when the same one is declared several times
+    vector<ActionKey> beforeKeys = actionKeys(before, beforeIds);
+    vector<ActionKey> afterKeys = actionKeys(after, afterIds);
+    const ActionTable& beforeTable = before.getActionTable();
+    const ActionTable& afterTable = after.getActionTable();
+    previousActions.assign(afterKeys.size(), -1);
+
+    // actions on new sorts come first (-1), they are added
+    i = j = 0;
+    while (i < beforeKeys.size() || j < afterKeys.size()) {
+        if (j == afterKeys.size() || (i < beforeKeys.size() && beforeKeys[i] < afterKeys[j])) {
+            removedActions++;
+            i++;
+        } else if (i == beforeKeys.size() || afterKeys[j] < beforeKeys[i]) {
+            addedActions++;
+            j++;
+        } else {
+            int p = beforeKeys[i].index, n = afterKeys[j].index;
+            previousActions[n] = p;
+            if (    beforeTable.getInfiniteRates()[p] != afterTable.getInfiniteRates()[n]
+                ||  beforeTable.getRates()[p] != afterTable.getRates()[n]
+                ||  beforeTable.getStochasticityAbsorptions()[p] != afterTable.getStochasticityAbsorptions()[n])
+                changedActions++;
+            i++;
+            j++;
+        }
+    }
+
+    skeletonChanged =   !addedSorts.empty() || !removedSorts.empty()
+                    ||  skeletonEdges(beforeKeys) != skeletonEdges(afterKeys);
+}
+
+
+bool PHDiff::isEmpty (void) {
+    return      addedSorts.empty() && removedSorts.empty() && resizedSorts.empty()
+            &&  addedActions == 0 && removedActions == 0 && changedActions == 0
+            &&  !headersChanged && !initialStateChanged;
+}
+
+
+// e.g. "1 sort", "3 sorts"
+static string count (size_t n, const string& noun) {
+    std::ostringstream res;
+    res << n << " " << noun << (n == 1 ? "" : "s");
+    return res.str();
+}
+
+
+string PHDiff::summary (void) {
+    std::ostringstream res;
+    const char* separator = "";
+    if (!addedSorts.empty())    { res << separator << count(addedSorts.size(), "sort") << " added";     separator = ", "; }
+    if (!removedSorts.empty())  { res << separator << count(removedSorts.size(), "sort") << " removed"; separator = ", "; }
+    if (!resizedSorts.empty())  { res << separator << count(resizedSorts.size(), "sort") << " resized"; separator = ", "; }
+    if (addedActions > 0)       { res << separator << count(addedActions, "action") << " added";        separator = ", "; }
+    if (removedActions > 0)     { res << separator << count(removedActions, "action") << " removed";    separator = ", "; }
+    if (changedActions > 0)     { res << separator << count(changedActions, "action") << " changed";    separator = ", "; }
+    if (headersChanged)         { res << separator << "headers changed";                        separator = ", "; }
+    if (initialStateChanged)    { res << separator << "initial state changed";                  separator = ", "; }
+    return isEmpty() ? "no change" : res.str();
+}
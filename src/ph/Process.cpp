@@ -1,21 +1,32 @@
-#include <boost/lexical_cast.hpp>
+#include <sstream>
 #include "Process.h"
 
 
-Process::Process (SortPtr s, const int& n) : sort(s), number(n) {}
+Process::Process (SortPtr s, const int& n) : sort(s), number(n), id(-1) {}
 
 
 // output for DOT file
 string Process::toDotString () {
-	string n = boost::lexical_cast<string>(number);
-	return getDotName() + " [label=\"" + n + "\"];\n";
+	std::ostringstream res;
+	writeDot(res);
+	return res.str();
+}
+
+void Process::writeDot (std::ostream& out) {
+	writeDotName(out);
+	out << " [label=\"" << number << "\"];\n";
 }
 
 
 // build name for DOT file
 string Process::getDotName () {
-	string n = boost::lexical_cast<string>(number);
-	return sort->getName() + "_p" + n;
+	std::ostringstream res;
+	writeDotName(res);
+	return res.str();
+}
+
+void Process::writeDotName (std::ostream& out) {
+	out << sort->getName() << "_p" << number;
 }
 
 
@@ -28,4 +39,6 @@ void Process::setGProcess(GProcessPtr gPPtr) {
 // getters
 int Process::getNumber () { return number; }
 SortPtr Process::getSort () { return sort; }
+int Process::getId () { return id; }
+void Process::setId (const int& i) { id = i; }
 GProcessPtr Process::getGProcess() { return gProcess; }
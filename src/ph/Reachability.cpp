@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include "Exceptions.h"
+#include "Reachability.h"
+#include "Trace.h"
+
+
+Reachability::Options::Options (void) : threads(0), maxStates(1 << 22) {}
+
+Reachability::Result::Result (void) : answer(Unknown), states(0), depth(0), elapsed(0) {}
+
+
+// number of states a worker takes at once from the current level
+static const size_t chunkSize = 256;
+
+
+Reachability::Reachability (PH& ph) {
+
+    // sorts packed in 64 bit words, a sort never spanning two words
+    int n = ph.countSorts();
+    word.resize(n);
+    shift.resize(n);
+    mask.resize(n);
+    offset.resize(n + 1);
+    words = 1;
+    int bit = 0;
+    for (int s = 0; s < n; s++) {
+        SortPtr sort = ph.getSort(s);
+        int width = 0;
+        while ((1 << width) < sort->countProcesses())
+            width++;
+        if (bit + width > 64) {
+            words++;
+            bit = 0;
+        }
+        word[s] = words - 1;
+        shift[s] = bit;
+        mask[s] = width == 0 ? 0 : (~(uint64_t) 0) >> (64 - width);
+        bit += width;
+        offset[s + 1] = offset[s] + sort->countProcesses();
+    }
+
+    initial.assign(words, 0);
+    for (int s = 0; s < n; s++)
+        set(&initial[0], s, ph.getSort(s)->getActiveProcess()->getNumber());
+
+    // transitions by target process, self-loops (result = target) left out
+    const ActionTable& table = ph.getActionTable();
+    vector<int> count(offset[n] + 1, 0);
+    vector<int> targets(table.size());
+    for (int a = 0; a < table.size(); a++) {
+        ProcessPtr target = ph.getProcess(table.getTargets()[a]);
+        targets[a] = offset[target->getSort()->getId()] + target->getNumber();
+        if (ph.getProcess(table.getResults()[a]) != target)
+            count[targets[a] + 1]++;
+    }
+    for (int p = 0; p < offset[n]; p++)
+        count[p + 1] += count[p];
+    first.assign(count.begin(), count.end());
+    transitions.resize(first[offset[n]]);
+    for (int a = 0; a < table.size(); a++) {
+        ProcessPtr hitter = ph.getProcess(table.getSources()[a]);
+        ProcessPtr result = ph.getProcess(table.getResults()[a]);
+        if (result == ph.getProcess(table.getTargets()[a]))
+            continue;
+        Transition& t = transitions[count[targets[a]]++];
+        t.hitterSort = hitter->getSort()->getId();
+        t.hitter = hitter->getNumber();
+        t.result = result->getNumber();
+        t.action = a;
+    }
+}
+
+
+vector<Reachability::Requirement> Reachability::parseGoal (PH& ph, const string& goal) {
+    vector<Requirement> res;
+    std::istringstream input(goal);
+    string name, number;
+    while (input >> name) {
+        SortPtr sort = ph.getSort(name);
+        if (!(input >> number))
+            throw process_required() << sort_info(name);
+        char* end;
+        long p = strtol(number.c_str(), &end, 10);
+        if (*end != '\0' || p < 0 || p >= sort->countProcesses())
+            throw process_not_found() << sort_info(name) << process_info(p);
+        res.push_back(Requirement(sort->getId(), p));
+    }
+    return res;
+}
+
+
+int Reachability::countWords (void) { return words; }
+
+int Reachability::get (const uint64_t* state, int sort) {
+    return (state[word[sort]] >> shift[sort]) & mask[sort];
+}
+
+void Reachability::set (uint64_t* state, int sort, int process) {
+    uint64_t& w = state[word[sort]];
+    w = (w & ~(mask[sort] << shift[sort])) | ((uint64_t) process << shift[sort]);
+}
+
+string Reachability::answerName (Answer answer) {
+    switch (answer) {
+        case Reachable:     return "reachable";
+        case Unreachable:   return "unreachable";
+        default:            return "unknown";
+    }
+}
+
+
+// the states met: open addressing, each slot being claimed by a compare and swap on its flag,
+// along with the slot of the state it was reached from and the action played
+class StateSet {
+
+    public:
+
+        enum Slot { EmptySlot, BusySlot, StoredSlot };
+
+        // results of insert() which are not a slot
+        static const int64_t present = -1;
+        static const int64_t full = -2;
+
+        StateSet (int words_, size_t limit_) : words(words_), limit(limit_), count(0) {
+            capacity = 1024;
+            while (capacity < 2 * limit)
+                capacity *= 2;
+            mask = capacity - 1;
+            // the states are not initialized, so that only the pages used are allocated
+            data.reset(new uint64_t[capacity * words]);
+            parents.reset(new uint32_t[capacity]);
+            actions.reset(new int32_t[capacity]);
+            flags.reset(new std::atomic<uint32_t>[capacity]);
+            for (size_t i = 0; i < capacity; i++)
+                flags[i].store(EmptySlot, std::memory_order_relaxed);
+        }
+
+        // the slot of a new state, present if it was already met, full if the limit is reached
+        int64_t insert (const uint64_t* state, uint32_t parent, int32_t action) {
+            uint64_t h = 0;
+            for (int w = 0; w < words; w++)
+                h = mix(h ^ state[w]);
+            size_t i = h & mask;
+            for (;;) {
+                uint32_t f = flags[i].load(std::memory_order_acquire);
+                if (f == EmptySlot) {
+                    if (count.load(std::memory_order_relaxed) >= limit)
+                        return full;
+                    if (flags[i].compare_exchange_strong(f, BusySlot, std::memory_order_acquire)) {
+                        std::memcpy(at(i), state, words * sizeof(uint64_t));
+                        parents[i] = parent;
+                        actions[i] = action;
+                        flags[i].store(StoredSlot, std::memory_order_release);
+                        count.fetch_add(1, std::memory_order_relaxed);
+                        return i;
+                    }
+                }
+                // another thread is writing this slot
+                while (f == BusySlot)
+                    f = flags[i].load(std::memory_order_acquire);
+                if (std::memcmp(at(i), state, words * sizeof(uint64_t)) == 0)
+                    return present;
+                i = (i + 1) & mask;
+            }
+        }
+
+        uint64_t* at (size_t slot) { return data.get() + slot * words; }
+        uint32_t parent (size_t slot) { return parents[slot]; }
+        int32_t action (size_t slot) { return actions[slot]; }
+        size_t size (void) { return count.load(std::memory_order_relaxed); }
+
+    private:
+
+        static uint64_t mix (uint64_t h) {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        int words;
+        size_t limit;
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<uint64_t[]> data;
+        std::unique_ptr<uint32_t[]> parents;
+        std::unique_ptr<int32_t[]> actions;
+        std::unique_ptr<std::atomic<uint32_t>[]> flags;
+        std::atomic<size_t> count;
+};
+
+
+// what the workers share while exploring a level
+struct Exploration {
+    Reachability* r;
+    const vector<Reachability::Requirement>* goal;
+    std::function<bool ()> cancelled;
+    StateSet* states;
+    const vector<uint32_t>* level;
+    std::atomic<size_t> cursor;
+    std::atomic<bool> stop;
+    std::atomic<bool> full;
+    std::atomic<int64_t> found;
+};
+
+
+// explores chunks of the current level, the new states going to the next one
+class ReachabilityWorker : public QRunnable {
+
+    public:
+        ReachabilityWorker (Exploration* e_, vector<uint32_t>* next_) : e(e_), next(next_) {}
+
+        void run () {
+            Reachability& r = *e->r;
+            vector<uint64_t> state(r.words), successor(r.words);
+            int sorts = r.word.size();
+            while (!e->stop.load(std::memory_order_relaxed)) {
+                size_t begin = e->cursor.fetch_add(chunkSize);
+                if (begin >= e->level->size())
+                    return;
+                if (e->cancelled && e->cancelled()) {
+                    e->stop = true;
+                    return;
+                }
+                size_t end = std::min(begin + chunkSize, e->level->size());
+                for (size_t i = begin; i < end; i++) {
+                    uint32_t from = (*e->level)[i];
+                    std::memcpy(&state[0], e->states->at(from), r.words * sizeof(uint64_t));
+                    for (int s = 0; s < sorts; s++) {
+                        int p = r.offset[s] + r.get(&state[0], s);
+                        for (int k = r.first[p]; k < r.first[p + 1]; k++) {
+                            const Reachability::Transition& t = r.transitions[k];
+                            if (r.get(&state[0], t.hitterSort) != t.hitter)
+                                continue;
+                            successor = state;
+                            r.set(&successor[0], s, t.result);
+                            int64_t slot = e->states->insert(&successor[0], from, t.action);
+                            if (slot == StateSet::present)
+                                continue;
+                            if (slot == StateSet::full) {
+                                e->full = true;
+                                e->stop = true;
+                                return;
+                            }
+                            next->push_back(slot);
+                            if (satisfies(&successor[0])) {
+                                e->found = slot;
+                                e->stop = true;
+                                return;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        bool satisfies (const uint64_t* state) {
+            for (const Reachability::Requirement &g : *e->goal)
+                if (e->r->get(state, g.first) != g.second)
+                    return false;
+            return true;
+        }
+
+    private:
+        Exploration* e;
+        vector<uint32_t>* next;
+};
+
+
+Reachability::Result Reachability::run (const vector<Requirement>& goal, const Options& options
+                                        , Progress progress, std::function<bool ()> cancelled) {
+
+    TRACE_SCOPE("reachability");
+    qint64 start = Trace::now();
+    int threads = options.threads > 0 ? options.threads : QThread::idealThreadCount();
+
+    StateSet states(words, std::max<size_t>(1, std::min<size_t>(options.maxStates, 1u << 30)));
+    Exploration e;
+    e.r = this;
+    e.goal = &goal;
+    e.cancelled = cancelled;
+    e.states = &states;
+    e.stop = false;
+    e.full = false;
+    e.found = -1;
+
+    Result res;
+    // the initial state is its own parent
+    vector<uint32_t> level(1, states.insert(&initial[0], 0, -1));
+    ReachabilityWorker check(&e, NULL);
+    if (check.satisfies(&initial[0]))
+        e.found = level[0];
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    vector< vector<uint32_t> > next(threads);
+
+    while (e.found < 0 && !level.empty() && !e.stop) {
+
+        // the level is shared by the workers, each one filling its part of the next level
+        e.level = &level;
+        e.cursor = 0;
+        int workers = std::min<size_t>(threads, (level.size() + chunkSize - 1) / chunkSize);
+        for (int t = 0; t < workers; t++) {
+            next[t].clear();
+            pool.start(new ReachabilityWorker(&e, &next[t]));
+        }
+        pool.waitForDone();
+        res.depth++;
+
+        level.clear();
+        for (int t = 0; t < workers; t++)
+            level.insert(level.end(), next[t].begin(), next[t].end());
+        if (progress)
+            progress(res.depth, states.size());
+    }
+
+    // the last level explored gave no new state, unless one was found
+    if (e.found >= 0) {
+        res.answer = Reachable;
+        for (uint32_t s = e.found; states.action(s) >= 0; s = states.parent(s))
+            res.witness.push_back(states.action(s));
+        std::reverse(res.witness.begin(), res.witness.end());
+    } else {
+        res.answer = e.stop ? Unknown : Unreachable;
+        res.depth = std::max(0, res.depth - 1);
+    }
+    res.states = states.size();
+    res.elapsed = (Trace::now() - start) / 1000;
+    return res;
+}
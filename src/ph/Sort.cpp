@@ -1,31 +1,10 @@
-#include <boost/lexical_cast.hpp>
-#include <boost/make_shared.hpp>
+#include <sstream>
 #include "Exceptions.h"
 #include "Sort.h"
 
-using boost::make_shared;
-
-
-// create a new Sort
-SortPtr Sort::make (const string& name, const int& processes) {
-
-    // initialize Sort
-	SortPtr s (new Sort(name));
-
-    // add Processes
-	if (processes < 1) throw process_required();
-	for (int i = 0; i < processes + 1; i++)
-		s->addProcess(make_shared<Process>(s, i));
-
-    // set first Process as active Process
-	s->setActiveProcess(0);
-
-    return s;
-}
-
 
 // private constructor
-Sort::Sort (const string& n) : name(n) {}
+Sort::Sort (const string& n) : name(n), id(-1) {}
 
 
 // add a Process
@@ -36,23 +15,34 @@ void Sort::addProcess (ProcessPtr p) {
 
 // output for DOT file
 string Sort::toDotString (void) {
-	string res;
+	std::ostringstream res;
+	writeDot(res);
+	return res.str();
+}
 
-    // output Processes
-	res += "subgraph cluster_" + name + " {\n";
-	res += "\tlabel = \"Sort " + name + "\";\n";
-	res += "\tcolor = lightgray;\n";
-    for (ProcessPtr &p : processes)
-		res += "\t" + p->toDotString();
-	res += "}\n";
+void Sort::writeDot (std::ostream& out) {
 
-	return res;
+    // output Processes
+	out << "subgraph cluster_" << name << " {\n";
+	out << "\tlabel = \"Sort " << name << "\";\n";
+	out << "\tcolor = lightgray;\n";
+    for (ProcessPtr &p : processes) {
+		out << '\t';
+		p->writeDot(out);
+	}
+	out << "}\n";
 }
 
 
 // output for PH file
 string Sort::toString (void) {
-	return "process " + getName() + " " +  boost::lexical_cast<string>(processes.size() - 1) + "\n";
+	std::ostringstream res;
+	write(res);
+	return res.str();
+}
+
+void Sort::write (std::ostream& out) {
+	out << "process " << name << ' ' << processes.size() - 1 << '\n';
 }
 
 // getters & setters
@@ -62,12 +52,14 @@ ProcessPtr Sort::getProcess (const uint& i) {
 	return processes[i];
 }
 
-vector<ProcessPtr> Sort::getProcesses (void) {	
+const vector<ProcessPtr>& Sort::getProcesses (void) {	
 	return processes;
 }
 
 void Sort::setActiveProcess (const int& i) { activeProcess = getProcess(i); }
 ProcessPtr Sort::getActiveProcess (void) { return activeProcess; }
 
-string Sort::getName (void) { return name; }
+const string& Sort::getName (void) { return name; }
+int Sort::getId (void) { return id; }
+void Sort::setId (const int& i) { id = i; }
 int Sort::countProcesses() { return processes.size() ; }
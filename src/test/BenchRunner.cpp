@@ -0,0 +1,14 @@
+#include <QApplication>
+#include <QtTest/QtTest>
+#include "PHBench.h"
+
+/**
+ * @file BenchRunner.cpp
+ * @brief this file contains the main program for benchmark mode
+ */
+
+int main (int argc, char ** argv) {
+	QApplication app(argc, argv);
+	PHBench bench;
+	return QTest::qExec(&bench, argc, argv);
+}
@@ -0,0 +1,224 @@
+#include <string>
+#include "Area.h"
+#include "Exceptions.h"
+#include "GSort.h"
+#include "IO.h"
+#include "MainWindow.h"
+#include "PHBench.h"
+#include "PHGenerator.h"
+#include "PHIO.h"
+#include "PHScene.h"
+#include "Fixpoints.h"
+#include "LocalCausality.h"
+#include "Reachability.h"
+#include "SyntheticDump.h"
+
+using std::string;
+
+
+// models: the samples, then generated ones of increasing size for each topology
+static void addModels (void) {
+	QTest::addColumn<QString>("name");
+	QTest::addColumn<QByteArray>("content");
+	QStringList samples;
+	samples << "metazoan" << "ERBB_G1-S" << "tcrsig40" << "tcrsig94" << "egfr104";
+	for (const QString &s : samples) {
+		string content = IO::readFile(("samples/" + s + ".ph").toStdString());
+		QTest::newRow(qPrintable(s)) << s << QByteArray(content.data(), content.size());
+	}
+	const char* topologies[] = { "scale-free", "modular", "layered" };
+	int sizes[] = { 100, 1000 };
+	for (const char* t : topologies)
+		for (int n : sizes) {
+			PHGenerator::Options options;
+			PHGenerator::topologyFromName(t, options.topology);
+			options.sorts = n;
+			QString name = QString(t) + "-" + QString::number(n);
+			string content = PHGenerator::generate(options);
+			QTest::newRow(qPrintable(name)) << name << QByteArray(content.data(), content.size());
+		}
+}
+
+
+// the model of the current row, parsed (macros expanded)
+static PHPtr parseRow (void) {
+	QFETCH(QByteArray, content);
+	return PHIO::parseContent(content.constData(), content.size());
+}
+
+
+// scanner and AXE grammar on the same synthetic dump
+void PHBench::scan_data()  {
+	QTest::addColumn<bool>("axe");
+	QTest::newRow("scanner") 		<< false;
+	QTest::newRow("axe") 			<< true;
+ }
+
+
+ void PHBench::scan()  {
+	QFETCH(bool, axe);
+	string input = syntheticDump(200, 100000);
+	QBENCHMARK {
+		if (axe)
+			PHIO::parseWithAxe(input);
+		else
+			PHIO::parse(input.data(), input.length());
+	}
+ }
+
+
+// parsing, without the cache of compiled models
+void PHBench::parse_data()  { addModels(); }
+
+ void PHBench::parse()  {
+	QFETCH(QByteArray, content);
+	QBENCHMARK {
+		PHIO::parseContent(content.constData(), content.size());
+	}
+ }
+
+
+// skeleton graph and graphviz layout
+void PHBench::layout_data()  { addModels(); }
+
+ void PHBench::layout()  {
+	PHPtr ph = parseRow();
+	QBENCHMARK {
+		ph->createSkeletonGraph();
+	}
+ }
+
+
+// scene items (sorts, processes, actions) from a layout, in a new scene each time
+void PHBench::drawScene_data()  { addModels(); }
+
+ void PHBench::drawScene()  {
+	PHPtr ph = parseRow();
+	QList<GVNode> layout = ph->layoutSkeleton();
+	QBENCHMARK {
+		PHScene scene(ph.get());
+		scene.drawFromSkeleton(layout);
+	}
+ }
+
+
+// moving a sort, which updates all the actions of the scene
+void PHBench::dragSort_data()  { addModels(); }
+
+ void PHBench::dragSort()  {
+	PHPtr ph = parseRow();
+	ph->render();
+	GSortPtr sort = ph->getGraphicsScene()->getGSort(0);
+	QBENCHMARK {
+		sort->shiftPosition(QPointF(1, 1));
+	}
+ }
+
+
+// rendering the scene as a PNG file
+void PHBench::exportPNG_data()  { addModels(); }
+
+ void PHBench::exportPNG()  {
+	PHPtr ph = parseRow();
+	ph->render();
+	QString path = QDir::tempPath() + "/PHBench.png";
+	QBENCHMARK {
+		PHIO::exportToPNG(ph, path);
+	}
+	QFile::remove(path);
+ }
+
+
+// style and layout saved as XML then read back, in a tab of a main window
+void PHBench::xmlRoundTrip_data()  { addModels(); }
+
+ void PHBench::xmlRoundTrip()  {
+	QFETCH(QString, name);
+	QFETCH(QByteArray, content);
+	PHPtr ph = parseRow();
+	MainWindow window;
+	window.addTab(name + ".ph", ph, ph->layoutSkeleton(), QString(content));
+	QString path = QDir::tempPath() + "/PHBench.xml";
+	QBENCHMARK {
+		QFile output(path);
+		QVERIFY(output.open(QIODevice::WriteOnly));
+		PHIO::exportXMLMetadata(&window, output);
+		output.close();
+		window.importXMLMetadata(path);
+	}
+	QFile::remove(path);
+ }
+
+
+// exploration of the states, on one thread then on all the cores
+void PHBench::reach_data()  {
+	QTest::addColumn<QString>("topology");
+	QTest::addColumn<int>("threads");
+	const char* topologies[] = { "scale-free", "modular", "layered" };
+	for (const char* t : topologies) {
+		QTest::newRow(qPrintable(QString(t) + "-1-thread")) 	<< QString(t) << 1;
+		QTest::newRow(qPrintable(QString(t) + "-all-threads")) 	<< QString(t) << 0;
+	}
+ }
+
+ void PHBench::reach()  {
+	QFETCH(QString, topology);
+	QFETCH(int, threads);
+	PHGenerator::Options generated;
+	PHGenerator::topologyFromName(topology.toStdString(), generated.topology);
+	string content = PHGenerator::generate(generated);
+	PHPtr ph = PHIO::parseContent(content.data(), content.length());
+	Reachability engine(*ph);
+	Reachability::Options options;
+	options.threads = threads;
+	options.maxStates = 1 << 20;
+	// never satisfied (no such process): explores until the limit
+	vector<Reachability::Requirement> goal(1, Reachability::Requirement(0, ph->getSort(0)->countProcesses()));
+	QBENCHMARK {
+		engine.run(goal, options);
+	}
+ }
+
+
+// static analysis of one process of each sort, the solutions being shared by the queries
+void PHBench::localCausality_data()  {
+	QTest::addColumn<QString>("topology");
+	QTest::newRow("scale-free") 	<< "scale-free";
+	QTest::newRow("modular") 		<< "modular";
+	QTest::newRow("layered") 		<< "layered";
+ }
+
+ void PHBench::localCausality()  {
+	QFETCH(QString, topology);
+	PHGenerator::Options generated;
+	PHGenerator::topologyFromName(topology.toStdString(), generated.topology);
+	string content = PHGenerator::generate(generated);
+	PHPtr ph = PHIO::parseContent(content.data(), content.length());
+	QBENCHMARK {
+		LocalCausality causality(*ph);
+		for (int s = 0; s < ph->countSorts(); s++)
+			causality.run(vector<Reachability::Requirement>(1, Reachability::Requirement(s, ph->getSort(s)->countProcesses() - 1)));
+	}
+ }
+
+
+// enumeration of the fixpoints, on one thread then on all the cores
+void PHBench::fixpoints_data()  {
+	reach_data();
+ }
+
+ void PHBench::fixpoints()  {
+	QFETCH(QString, topology);
+	QFETCH(int, threads);
+	PHGenerator::Options generated;
+	PHGenerator::topologyFromName(topology.toStdString(), generated.topology);
+	string content = PHGenerator::generate(generated);
+	PHPtr ph = PHIO::parseContent(content.data(), content.length());
+	Fixpoints engine(*ph);
+	Fixpoints::Options options;
+	options.threads = threads;
+	options.maxFixpoints = 1 << 16;
+	QBENCHMARK {
+		engine.run([] (const vector<Fixpoints::State>&) {}, options);
+	}
+ }
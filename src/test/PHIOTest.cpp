@@ -1,10 +1,43 @@
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
 #include <string>
+#include "Exceptions.h"
+#include "IO.h"
+#include "PHCache.h"
+#include "PHDiff.h"
+#include "ModelValidator.h"
+#include "AnalysisJob.h"
+#include "Fixpoints.h"
+#include "LocalCausality.h"
+#include "Reachability.h"
+#include "PHGenerator.h"
 #include "PHIOTest.h"
 #include "PHIO.h"
+#include "SyntheticDump.h"
 
+using std::map;
+using std::pair;
+using std::set;
 using std::string;
 
 
+// compiled models go to a directory of their own, rather than to the user's cache
+void PHIOTest::initTestCase()  {
+	cacheDirectory = QDir::tempPath() + "/PHIOTest-cache-" + QString::number(QCoreApplication::applicationPid());
+	qputenv("PAPPL_CACHE_DIR", QFile::encodeName(cacheDirectory));
+ }
+
+
+ void PHIOTest::cleanupTestCase()  {
+	QDir dir(cacheDirectory);
+	for (const QString &f : dir.entryList(QDir::Files))
+		dir.remove(f);
+	QDir().rmdir(cacheDirectory);
+ }
+
+
 // test parser on various operations
 void PHIOTest::parse_data()  {
 	QTest::addColumn<QString>("source");
@@ -27,3 +60,582 @@ void PHIOTest::parse_data()  {
 	QFETCH(QString, source);
 	QVERIFY(PHIO::canParseFile(source.toStdString()));
  }
+
+
+static bool declared (PHPtr other, SortPtr s) {
+	try {
+		other->getSort(s->getName());
+		return true;
+	} catch (sort_not_found&) {
+		return false;
+	}
+}
+
+// a process, as a sort name and a number
+typedef pair<string, int> Named;
+
+// the cooperative processes of ph (sorts not declared in the other model) renamed after the cooperative
+// processes of the other model reflecting the same state of the same sorts, found from the actions keeping
+// them up to date
+static map<Named, Named> cooperativeRenaming (PHPtr ph, PHPtr other) {
+	auto reflected = [] (PHPtr ph, PHPtr other) -> map< Named, map<string, int> > {
+		map< Named, map<string, int> > res;
+		for (int i = 0; i < ph->countActions(); i++) {
+			Action a = ph->getAction(i);
+			SortPtr hitter = a.getSource()->getSort();
+			SortPtr target = a.getTarget()->getSort();
+			if (declared(other, hitter) && !declared(other, target))
+				res[Named(target->getName(), a.getResult()->getNumber())][hitter->getName()] = a.getSource()->getNumber();
+		}
+		return res;
+	};
+	map< map<string, int>, Named > byState;
+	for (const pair<const Named, map<string, int> > &p : reflected(other, ph))
+		byState[p.second] = p.first;
+	map<Named, Named> res;
+	for (const pair<const Named, map<string, int> > &p : reflected(ph, other)) {
+		map< map<string, int>, Named >::iterator found = byState.find(p.second);
+		if (found != byState.end())
+			res[p.first] = found->second;
+	}
+	return res;
+}
+
+// sorts (with their initial process) and actions as text, sorted, processes being renamed
+static string normalized (PHPtr ph, const map<Named, Named>& renaming = map<Named, Named>()) {
+	auto rename = [&renaming] (ProcessPtr p) {
+		Named n(p->getSort()->getName(), p->getNumber());
+		map<Named, Named>::const_iterator found = renaming.find(n);
+		return found == renaming.end() ? n : found->second;
+	};
+	vector<string> lines;
+	for (SortPtr &s : ph->getSorts()) {
+		Named active = rename(s->getActiveProcess());
+		std::ostringstream line;
+		line << "process " << active.first << " " << s->countProcesses() - 1 << " initially " << active.second << "\n";
+		lines.push_back(line.str());
+	}
+	for (int i = 0; i < ph->countActions(); i++) {
+		Action a = ph->getAction(i);
+		Named hitter = rename(a.getSource());
+		Named target = rename(a.getTarget());
+		Named result = rename(a.getResult());
+		string text = a.toString();
+		std::ostringstream line;
+		line << hitter.first << " " << hitter.second << " -> " << target.first << " " << target.second << " "
+				<< result.second << text.substr(text.find(" @"));
+		lines.push_back(line.str());
+	}
+	std::sort(lines.begin(), lines.end());
+	string res;
+	for (string &l : lines)
+		res += l;
+	return res;
+}
+
+
+// native macro expansion against phc
+void PHIOTest::expand_data()  {
+	QTest::addColumn<QString>("source");
+	QTest::newRow("metazoan") 		<< "samples/metazoan.ph";
+	QTest::newRow("ERBB_G1") 		<< "samples/ERBB_G1-S.ph";
+	QTest::newRow("tcrsig40") 		<< "samples/tcrsig40.ph";
+	QTest::newRow("tcrsig94") 		<< "samples/tcrsig94.ph";
+	QTest::newRow("egfr104") 		<< "samples/egfr104.ph";
+	QTest::newRow("tgf_CADBIOM") 	<< "samples/tgf_CADBIOM.ph";
+ }
+
+
+ void PHIOTest::expand()  {
+	QFETCH(QString, source);
+	string content = IO::readFile(source.toStdString());
+	PHPtr native = PHIO::parseContentNatively(content.data(), content.size());
+	PHPtr reference;
+	try {
+		reference = PHIO::parseFileWithPhc(source.toStdString());
+	} catch (pint_program_not_found&) {
+		QSKIP("phc is not available", SkipAll);
+	}
+	QCOMPARE(normalized(native, cooperativeRenaming(native, reference)), normalized(reference));
+ }
+
+
+// native macro expansion against hand-written expansions
+void PHIOTest::macros_data()  {
+	QTest::addColumn<QString>("input");
+	QTest::addColumn<QString>("expected");
+	QString abc = "process a 1\nprocess b 1\nprocess c 1\n";
+	QString updates = "process a_and_b 3\n"
+			"a 1 -> a_and_b 0 2\na 1 -> a_and_b 1 3\na 0 -> a_and_b 2 0\na 0 -> a_and_b 3 1\n"
+			"b 1 -> a_and_b 0 1\nb 0 -> a_and_b 1 0\nb 1 -> a_and_b 2 3\nb 0 -> a_and_b 3 2\n";
+	QTest::newRow("cooperativity") 	<< abc + "COOPERATIVITY([a;b] -> c 0 1, [[1;1]])\ninitial_state a 1\n"
+									<< abc + updates + "a_and_b 3 -> c 0 1\ninitial_state a 1, a_and_b 2\n";
+	QTest::newRow("formula") 		<< abc + "COOPERATIVITY([a] in [[1]] or not [b] in [[0]], c, 0, 1)\n"
+									<< abc + updates + "a_and_b 1 -> c 0 1\na_and_b 2 -> c 0 1\na_and_b 3 -> c 0 1\n";
+	QTest::newRow("knockdown") 		<< abc + "b 1 -> a 0 1\nb 0 -> a 1 0\nKNOCKDOWN(a)\ninitial_state a 1\n"
+									<< abc + "b 0 -> a 1 0\n";
+	QTest::newRow("rm") 			<< abc + "a 1 -> b 0 1\na 0 -> b 1 0\nRM({a 0 -> b 1 0})\n"
+									<< abc + "a 1 -> b 0 1\n";
+	QTest::newRow("grn") 			<< "process a 1\nprocess b 2\nGRN([a 1 -> + b])\n"
+									<< "process a 1\nprocess b 2\n"
+										"a 1 -> b 0 1\na 1 -> b 1 2\na 0 -> b 1 0\na 0 -> b 2 1\na 1 -> a 1 0\n";
+	QTest::newRow("grn loop") 		<< "process a 1\nprocess b 1\nGRN([a 1 -> - b; b 1 -> + a])\n"
+									<< "process a 1\nprocess b 1\na 0 -> b 0 1\na 1 -> b 1 0\nb 1 -> a 0 1\nb 0 -> a 1 0\n";
+	QTest::newRow("name taken") 	<< abc + "process a_and_b 3\nCOOPERATIVITY([a;b] -> c 0 1, [[1;1]])\n"
+									<< QString();
+ }
+
+
+ void PHIOTest::macros()  {
+	QFETCH(QString, input);
+	QFETCH(QString, expected);
+	string in = input.toStdString();
+	string out = expected.toStdString();
+	if (expected.isNull()) {
+		try {
+			PHIO::parseContentNatively(in.data(), in.size());
+			QFAIL("ph_parse_error expected");
+		} catch (ph_parse_error&) {
+		}
+		return;
+	}
+	QCOMPARE(normalized(PHIO::parseContentNatively(in.data(), in.size())), normalized(PHIO::parse(out.data(), out.size())));
+ }
+
+
+// actions as text, in order
+static string actionsToString (PHPtr ph) {
+	string res;
+	for (int i = 0; i < ph->countActions(); i++)
+		res += ph->getAction(i).toString();
+	return res;
+}
+
+
+// b goes up when a is active, then c when b is at its top
+static const QString chain = "process a 1\nprocess b 2\nprocess c 1\na 1 -> b 0 1\nb 1 -> b 1 2\nb 2 -> c 0 1\n";
+
+
+// the witness leads from the initial state to the goal, each action being playable in turn
+static void checkWitness (PHPtr ph, const vector<int>& witness, const vector<Reachability::Requirement>& goal) {
+	map<string, int> active;
+	for (SortPtr &s : ph->getSorts())
+		active[s->getName()] = s->getActiveProcess()->getNumber();
+	for (int a : witness) {
+		Action action = ph->getAction(a);
+		QCOMPARE(active[action.getSource()->getSort()->getName()], action.getSource()->getNumber());
+		QCOMPARE(active[action.getTarget()->getSort()->getName()], action.getTarget()->getNumber());
+		active[action.getTarget()->getSort()->getName()] = action.getResult()->getNumber();
+	}
+	for (const Reachability::Requirement &g : goal)
+		QCOMPARE(active[ph->getSort(g.first)->getName()], g.second);
+}
+
+
+// scanner against the former AXE grammar
+void PHIOTest::scan_data()  {
+	QTest::addColumn<QString>("input");
+	QTest::newRow("synthetic") 		<< QString::fromStdString(syntheticDump(10, 500));
+	QTest::newRow("comments") 		<< "(* a (* nested *)\n comment *)\nprocess a 1 (* b *)\nprocess b 2\na 1 -> b 0 1 @0.5~3\nb 2 -> a 1 0\n";
+	QTest::newRow("spaces") 		<< "process a 1\t\nprocess b 1\n\na 1  ->  b 0 1 @ 2.5 ~ 4 \ninitial_state a 1 ,b 1\n";
+ }
+
+
+ void PHIOTest::scan()  {
+	QFETCH(QString, input);
+	string dump = input.toStdString();
+	PHPtr scanned = PHIO::parse(dump.data(), dump.length());
+	PHPtr reference = PHIO::parseWithAxe(dump);
+	QCOMPARE(actionsToString(scanned), actionsToString(reference));
+	QCOMPARE(scanned->toString(), reference->toString());
+
+	// identifiers are dense
+	for (int i = 0; i < scanned->countSorts(); i++)
+		QCOMPARE(scanned->getSort(i)->getId(), i);
+	for (int i = 0; i < scanned->countProcesses(); i++)
+		QCOMPARE(scanned->getProcess(i)->getId(), i);
+
+	// indexes list the same actions as a full scan
+	const ActionTable& table = scanned->getActionTable();
+	for (int p = 0; p < scanned->countProcesses(); p++) {
+		int expected = 0;
+		for (int i = 0; i < table.size(); i++)
+			expected += (table.getSources()[i] == p);
+		QCOMPARE(scanned->getActionsBySource(p).size(), expected);
+		for (int i : scanned->getActionsByTarget(p))
+			QCOMPARE(table.getTargets()[i], p);
+	}
+	for (int s = 0; s < scanned->countSorts(); s++)
+		for (int i : scanned->getActionsBySort(s)) {
+			Action a = scanned->getAction(i);
+			QVERIFY(a.getSource()->getSort()->getId() == s || a.getTarget()->getSort()->getId() == s);
+		}
+ }
+
+
+// compiled models give back the parsed model, stale or damaged ones are ignored
+void PHIOTest::compile_data()  {
+	QTest::addColumn<QString>("source");
+	QTest::newRow("headers") 		<< "tests/6_headers.ph";
+	QTest::newRow("footer") 		<< "tests/7_footer.ph";
+	QTest::newRow("metazoan") 		<< "tests/metazoan.ph";
+	QTest::newRow("tcrsig40") 		<< "tests/tcrsig40.ph";
+ }
+
+
+ void PHIOTest::compile()  {
+	QFETCH(QString, source);
+	string content = IO::readFile(source.toStdString());
+	PHPtr parsed = PHIO::parseContent(content.data(), content.length());
+	QByteArray key = PHCache::key(content.data(), content.length());
+	QString path = QDir::tempPath() + "/PHIOTest.phb";
+	QVERIFY(PHCache::write(path, key, parsed));
+
+	PHPtr loaded = PHCache::read(path, key);
+	QVERIFY(loaded);
+	QCOMPARE(loaded->toString(), parsed->toString());
+	QCOMPARE(actionsToString(loaded), actionsToString(parsed));
+	QCOMPARE(loaded->countProcesses(), parsed->countProcesses());
+
+	// another content
+	QVERIFY(!PHCache::read(path, PHCache::key("", 0)));
+
+	// truncated file
+	QFile file(path);
+	QVERIFY(file.resize(file.size() - 1));
+	QVERIFY(!PHCache::read(path, key));
+
+	// replaced, without leaving a temporary file
+	QVERIFY(PHCache::write(path, key, parsed));
+	QVERIFY(PHCache::read(path, key));
+	QVERIFY(QDir::temp().entryList(QStringList() << "PHIOTest.phb.tmp.*").isEmpty());
+	QFile::remove(path);
+
+	// stored in the cache directory only when asked to
+	QVERIFY(PHCache::directory() == cacheDirectory);
+	PHIO::parseCachedContent(content.data(), content.length(), source.toStdString(), false);
+	QVERIFY(!PHCache::load(key));
+	PHIO::parseCachedContent(content.data(), content.length(), source.toStdString(), true);
+	QVERIFY(PHCache::load(key));
+ }
+
+
+// compressed files are read and written as plain ones
+void PHIOTest::compressed_data()  {
+	QTest::addColumn<QString>("source");
+	QTest::newRow("headers") 		<< "tests/6_headers.ph";
+	QTest::newRow("metazoan") 		<< "tests/metazoan.ph";
+	QTest::newRow("tcrsig40") 		<< "tests/tcrsig40.ph";
+ }
+
+
+ void PHIOTest::compressed()  {
+	QFETCH(QString, source);
+	string content = IO::readFile(source.toStdString());
+	PHPtr plain = PHIO::parseFile(source.toStdString());
+	string path = (QDir::tempPath() + "/PHIOTest.ph.gz").toStdString();
+
+	IO::writeFile(path, content);
+	QCOMPARE(IO::readFile(path), content);
+	QCOMPARE(PHIO::parseFile(path)->toString(), plain->toString());
+
+	PHIO::writeToFile(path, plain);
+	QCOMPARE(PHIO::parseFile(path)->toString(), plain->toString());
+
+	// the file really is compressed, and damaged ones are reported
+	QFile file(QString::fromStdString(path));
+	QVERIFY(file.open(QIODevice::ReadWrite));
+	QByteArray compressed = file.readAll();
+	QVERIFY(IO::isCompressed(compressed.constData(), compressed.size()));
+	QVERIFY(file.resize(compressed.size() / 2));
+	file.close();
+	QVERIFY(!PHIO::canParseFile(path));
+	QFile::remove(QString::fromStdString(path));
+ }
+
+
+// differences between a model and edited versions of it
+static const char* diffModel = "process a 1\nprocess b 2\nprocess c 1\na 1 -> b 0 1 @1.\nb 1 -> c 0 1\nc 1 -> c 1 0\ninitial_state a 1\n";
+
+void PHIOTest::diff_data()  {
+	QTest::addColumn<QString>("edited");
+	QTest::addColumn<QString>("summary");
+	QTest::addColumn<bool>("skeletonChanged");
+	QString model = diffModel;
+	QTest::newRow("same") 			<< model << "no change" << false;
+	QTest::newRow("reordered") 		<< "process c 1\nprocess b 2\nprocess a 1\nc 1 -> c 1 0\nb 1 -> c 0 1\na 1 -> b 0 1 @1.\ninitial_state a 1\n" << "no change" << false;
+	QTest::newRow("rate") 			<< QString(model).replace("@1.", "@2.") << "1 action changed" << false;
+	QTest::newRow("action") 		<< model + "a 1 -> b 1 2\n" << "1 action added" << false;
+	QTest::newRow("edge") 			<< model + "c 1 -> a 1 0\n" << "1 action added" << true;
+	QTest::newRow("actions") 		<< model + "a 1 -> b 1 2\na 0 -> b 2 0\n" << "2 actions added" << false;
+	QTest::newRow("removed") 		<< QString(model).replace("b 1 -> c 0 1\n", "") << "1 action removed" << true;
+	QTest::newRow("sort") 			<< model + "process d 1\n" << "1 sort added" << true;
+	QTest::newRow("resized") 		<< QString(model).replace("process c 1", "process c 2") << "1 sort resized" << false;
+	QTest::newRow("initial") 		<< QString(model).replace("initial_state a 1", "initial_state a 0") << "initial state changed" << false;
+ }
+
+
+ void PHIOTest::diff()  {
+	QFETCH(QString, edited);
+	QFETCH(QString, summary);
+	QFETCH(bool, skeletonChanged);
+	string before = diffModel;
+	string after = edited.toStdString();
+	PHPtr ph = PHIO::parseContent(before.data(), before.length());
+	PHPtr other = PHIO::parseContent(after.data(), after.length());
+	PHDiff d(*ph, *other);
+	QCOMPARE(QString::fromStdString(d.summary()), summary);
+	QCOMPARE(d.skeletonChanged, skeletonChanged);
+
+	// kept actions point to the same action in the previous version
+	QCOMPARE((int) d.previousActions.size(), other->countActions());
+	for (int i = 0; i < other->countActions(); i++)
+		if (d.previousActions[i] >= 0) {
+			Action a = other->getAction(i), b = ph->getAction(d.previousActions[i]);
+			QCOMPARE(a.getSource()->getSort()->getName(), b.getSource()->getSort()->getName());
+			QCOMPARE(a.getTarget()->getSort()->getName(), b.getTarget()->getSort()->getName());
+			QCOMPARE(a.getResult()->getNumber(), b.getResult()->getNumber());
+		}
+ }
+
+
+// errors found while the text is edited, with their place (in characters)
+void PHIOTest::validate_data()  {
+	QTest::addColumn<QString>("text");
+	QTest::addColumn<int>("errors");
+	QTest::addColumn<int>("line");
+	QTest::addColumn<int>("column");
+	QTest::newRow("valid") 			<< "process a 1\na 0 -> a 0 1\n" << 0 << 0 << 0;
+	QTest::newRow("syntax") 		<< "process a 1\nprocess b x\n" << 1 << 2 << 11;
+	QTest::newRow("unicode") 		<< QString::fromUtf8("(* \xc3\xa9 *) process a x\n") << 1 << 1 << 19;
+	QTest::newRow("sort") 			<< "process a 1\na 1 -> b 0 1\n" << 1 << 2 << 0;
+	QTest::newRow("process") 		<< "process a 1\na 2 -> a 0 1\n" << 1 << 2 << 0;
+ }
+
+
+ void PHIOTest::validate()  {
+	QFETCH(QString, text);
+	QFETCH(int, errors);
+	QFETCH(int, line);
+	QFETCH(int, column);
+	QList<Diagnostic> diagnostics = ModelValidator::check(text.toUtf8());
+	QCOMPARE(diagnostics.size(), errors);
+	if (errors == 0)
+		return;
+	QCOMPARE(diagnostics[0].line, line);
+	if (column > 0)
+		QCOMPARE(diagnostics[0].column, column);
+	QVERIFY(!diagnostics[0].message.isEmpty());
+ }
+
+
+// analysis programs run in the background, their output being read as it comes
+void PHIOTest::analysisJob_data()  {
+	QTest::addColumn<QString>("script");
+	QTest::addColumn<bool>("cancel");
+	QTest::addColumn<int>("state");
+	QTest::addColumn<QString>("output");
+	QTest::newRow("finished") 		<< "echo 1; echo 2 >&2" << false << (int) AnalysisJob::Finished << "1\n2\n";
+	QTest::newRow("failed") 		<< "echo 1; exit 3" << false << (int) AnalysisJob::Failed << "1\n";
+	QTest::newRow("cancelled") 		<< "echo 1; sleep 30" << true << (int) AnalysisJob::Cancelled << "1\n";
+ }
+
+
+ void PHIOTest::analysisJob()  {
+	QFETCH(QString, script);
+	QFETCH(bool, cancel);
+	QFETCH(int, state);
+	QFETCH(QString, output);
+	AnalysisJob job("sh", QStringList() << "-c" << script, "");
+	job.start();
+	for (int i = 0; i < 100 && job.getOutput().isEmpty(); i++)
+		QTest::qWait(50);
+	if (cancel)
+		job.cancel();
+	for (int i = 0; i < 100 && job.isRunning(); i++)
+		QTest::qWait(50);
+	QVERIFY(!job.isRunning());
+	QCOMPARE((int) job.getState(), state);
+	QCOMPARE(job.getOutput(), output);
+ }
+
+
+// answers of the exploration of the states, whatever the number of threads
+void PHIOTest::reach_data()  {
+	QTest::addColumn<QString>("model");
+	QTest::addColumn<QString>("goal");
+	QTest::addColumn<int>("answer");
+	QTest::addColumn<int>("states");
+	QTest::addColumn<int>("depth");
+	QTest::newRow("initial") 		<< chain + "initial_state a 1\n" << "a 1" << (int) Reachability::Reachable << 1 << 0;
+	QTest::newRow("chain") 			<< chain + "initial_state a 1\n" << "c 1" << (int) Reachability::Reachable << 0 << 3;
+	QTest::newRow("together") 		<< chain + "initial_state a 1\n" << "b 2 c 1" << (int) Reachability::Reachable << 0 << 3;
+	QTest::newRow("unreachable") 	<< chain << "c 1" << (int) Reachability::Unreachable << 1 << 0;
+	QTest::newRow("all") 			<< chain + "initial_state a 1\n" << "b 0 c 1" << (int) Reachability::Unreachable << 4 << 3;
+ }
+
+
+ void PHIOTest::reach()  {
+	QFETCH(QString, model);
+	QFETCH(QString, goal);
+	QFETCH(int, answer);
+	QFETCH(int, states);
+	QFETCH(int, depth);
+	string content = model.toStdString();
+	PHPtr ph = PHIO::parseContent(content.data(), content.length());
+	Reachability engine(*ph);
+	for (int threads = 1; threads <= 4; threads *= 2) {
+		Reachability::Options options;
+		options.threads = threads;
+		Reachability::Result r = engine.run(Reachability::parseGoal(*ph, goal.toStdString()), options);
+		QCOMPARE((int) r.answer, answer);
+		QCOMPARE(r.depth, depth);
+		if (states > 0)
+			QCOMPARE((int) r.states, states);
+
+		// the witness leads to the goal
+		if (r.answer != Reachability::Reachable)
+			continue;
+		QCOMPARE((int) r.witness.size(), depth);
+		checkWitness(ph, r.witness, Reachability::parseGoal(*ph, goal.toStdString()));
+	}
+
+	// too few states allowed
+	Reachability::Options options;
+	options.maxStates = 1;
+	if (states > 1)
+		QCOMPARE((int) engine.run(Reachability::parseGoal(*ph, goal.toStdString()), options).answer, (int) Reachability::Unknown);
+ }
+
+
+// the static analysis agrees with the exploration of the states when it is conclusive
+void PHIOTest::localCausality_data()  {
+	QTest::addColumn<QString>("model");
+	QTest::addColumn<QString>("goal");
+	QTest::addColumn<int>("answer");
+	QTest::newRow("initial") 		<< chain + "initial_state a 1\n" << "a 1" << (int) Reachability::Reachable;
+	QTest::newRow("chain") 			<< chain + "initial_state a 1\n" << "c 1" << (int) Reachability::Reachable;
+	QTest::newRow("together") 		<< chain + "initial_state a 1\n" << "b 2 c 1" << (int) Reachability::Reachable;
+	QTest::newRow("never active") 	<< chain << "c 1" << (int) Reachability::Unreachable;
+	QTest::newRow("same sort") 		<< chain + "initial_state a 1\n" << "b 0 b 2" << (int) Reachability::Unreachable;
+	QTest::newRow("not conclusive") << chain + "initial_state a 1\n" << "b 0 c 1" << (int) Reachability::Unknown;
+ }
+
+
+ void PHIOTest::localCausality()  {
+	QFETCH(QString, model);
+	QFETCH(QString, goal);
+	QFETCH(int, answer);
+	string content = model.toStdString();
+	PHPtr ph = PHIO::parseContent(content.data(), content.length());
+	vector<Reachability::Requirement> requirements = Reachability::parseGoal(*ph, goal.toStdString());
+	LocalCausality causality(*ph);
+	LocalCausality::Result r = causality.run(requirements);
+	QCOMPARE((int) r.answer, answer);
+	if (r.answer != Reachability::Unknown)
+		QCOMPARE((int) r.answer, (int) Reachability(*ph).run(requirements).answer);
+
+	// the solutions are kept for the next queries
+	int objectives = causality.countObjectives();
+	QCOMPARE((int) causality.run(requirements).answer, answer);
+	QCOMPARE(causality.countObjectives(), objectives);
+
+	// the witness leads to the goal
+	if (r.answer == Reachability::Reachable)
+		checkWitness(ph, r.witness, requirements);
+ }
+
+
+// the fixpoints found are the states in which no action can be played, by brute force
+void PHIOTest::fixpoints_data()  {
+	QTest::addColumn<QString>("model");
+	QTest::addColumn<int>("count");
+	PHGenerator::Options generated;
+	generated.sorts = 6;
+	generated.processes = 3;
+	generated.macros = 0;
+	QTest::newRow("chain") 			<< chain << 4;
+	QTest::newRow("self hit") 		<< "process a 1\nprocess b 1\na 0 -> a 0 1\na 1 -> b 0 1\n" << 1;
+	QTest::newRow("none") 			<< "process a 1\na 0 -> a 0 1\na 1 -> a 1 0\n" << 0;
+	QTest::newRow("generated") 		<< QString::fromStdString(PHGenerator::generate(generated)) << -1;
+ }
+
+
+ void PHIOTest::fixpoints()  {
+	QFETCH(QString, model);
+	QFETCH(int, count);
+	string content = model.toStdString();
+	PHPtr ph = PHIO::parseContent(content.data(), content.length());
+
+	set< vector<int> > expected;
+	vector<int> state(ph->countSorts(), 0);
+	for (;;) {
+		bool fixed = true;
+		for (int a = 0; a < ph->countActions() && fixed; a++) {
+			Action action = ph->getAction(a);
+			fixed = 	action.getResult() == action.getTarget()
+					||	state[action.getSource()->getSort()->getId()] != action.getSource()->getNumber()
+					||	state[action.getTarget()->getSort()->getId()] != action.getTarget()->getNumber();
+		}
+		if (fixed)
+			expected.insert(state);
+		int s = 0;
+		while (s < (int) state.size() && ++state[s] == ph->getSort(s)->countProcesses())
+			state[s++] = 0;
+		if (s == (int) state.size())
+			break;
+	}
+	if (count >= 0)
+		QCOMPARE((int) expected.size(), count);
+
+	Fixpoints engine(*ph);
+	Fixpoints::Options options;
+	vector<Fixpoints::State> found;
+	Fixpoints::Found add = [&found] (const vector<Fixpoints::State>& batch) { found.insert(found.end(), batch.begin(), batch.end()); };
+	for (options.threads = 1; options.threads <= 4; options.threads *= 2) {
+		found.clear();
+		Fixpoints::Result r = engine.run(add, options);
+		QVERIFY(r.complete);
+		QCOMPARE((int) r.fixpoints, (int) expected.size());
+		QCOMPARE((int) found.size(), (int) expected.size());
+		QVERIFY(set< vector<int> >(found.begin(), found.end()) == expected);
+	}
+
+	// too many fixpoints
+	options.maxFixpoints = 1;
+	found.clear();
+	if (expected.size() > 1) {
+		QVERIFY(!engine.run(add, options).complete);
+		QCOMPARE((int) found.size(), 1);
+	}
+ }
+
+
+// generated models can be parsed, and only depend on the options
+void PHIOTest::generate_data()  {
+	QTest::addColumn<QString>("topology");
+	QTest::addColumn<int>("sorts");
+	QTest::newRow("scale-free") 	<< "scale-free" << 300;
+	QTest::newRow("modular") 		<< "modular" << 300;
+	QTest::newRow("layered") 		<< "layered" << 300;
+	QTest::newRow("one sort") 		<< "scale-free" << 1;
+ }
+
+
+ void PHIOTest::generate()  {
+	QFETCH(QString, topology);
+	QFETCH(int, sorts);
+	PHGenerator::Options options;
+	QVERIFY(PHGenerator::topologyFromName(topology.toStdString(), options.topology));
+	options.sorts = sorts;
+	options.macros = .3;
+	string content = PHGenerator::generate(options);
+	QCOMPARE(PHGenerator::generate(options), content);
+
+	PHPtr ph = PHIO::parseContent(content.data(), content.length());
+	QVERIFY(ph->countSorts() >= sorts);
+	QVERIFY(ph->countActions() >= sorts);
+
+	options.seed++;
+	QVERIFY(sorts == 1 || PHGenerator::generate(options) != content);
+ }
@@ -1,8 +1,13 @@
 #include "Area.h"
 #include "QHBoxLayout"
+#include <QLabel>
+#include <QSlider>
+#include <QTimer>
 #include "PHIO.h"
 #include "IO.h"
 #include "Exceptions.h"
+#include "PHDiff.h"
+#include "Trace.h"
 
 Area::Area(QWidget *parent, QString path) :
     QWidget(parent)
@@ -16,6 +21,7 @@ Area::Area(QWidget *parent, QString path) :
     this->treeArea = new TreeArea(this);
     this->indicatorEdit = new TextArea(this);
     this->listOldText = new QStringList();
+    this->validator = new ModelValidator(400, this);
 
     //Add text coloration (lie le TextArea)
     colorerSequences = new ColorerSequences(textArea->document());
@@ -74,11 +80,48 @@ Area::Area(QWidget *parent, QString path) :
     this->indicatorEdit->setVisible(false);
     //Press CTRL+E to save or CTRL+ESC to cancel
 
+    // replay bar, under the scene
+    this->replayBar = new QWidget(this);
+    QPushButton* previous = new QPushButton("<", this->replayBar);
+    previous->setMaximumWidth(30);
+    this->replayPlayButton = new QPushButton("Play", this->replayBar);
+    this->replayPlayButton->setMaximumWidth(60);
+    QPushButton* next = new QPushButton(">", this->replayBar);
+    next->setMaximumWidth(30);
+    this->replaySlider = new QSlider(Qt::Horizontal, this->replayBar);
+    this->replaySlider->setPageStep(1);
+    this->replayLabel = new QLabel(this->replayBar);
+    this->replayLabel->setMinimumWidth(200);
+    QPushButton* close = new QPushButton("Close", this->replayBar);
+    close->setMaximumWidth(60);
+    QHBoxLayout *replayLayout = new QHBoxLayout;
+    replayLayout->addWidget(previous);
+    replayLayout->addWidget(this->replayPlayButton);
+    replayLayout->addWidget(next);
+    replayLayout->addWidget(this->replaySlider, 1);
+    replayLayout->addWidget(this->replayLabel);
+    replayLayout->addWidget(close);
+    replayLayout->setContentsMargins(0,0,0,0);
+    this->replayBar->setLayout(replayLayout);
+    this->replayBar->setVisible(false);
+    this->replayTimer = new QTimer(this);
+    this->replayTimer->setInterval(1000);
+    QObject::connect(previous, SIGNAL(clicked()), this, SLOT(replayPrevious()));
+    QObject::connect(next, SIGNAL(clicked()), this, SLOT(replayNext()));
+    QObject::connect(this->replayPlayButton, SIGNAL(clicked()), this, SLOT(replayPlayOrPause()));
+    QObject::connect(close, SIGNAL(clicked()), this, SLOT(stopReplay()));
+    QObject::connect(this->replaySlider, SIGNAL(valueChanged(int)), this, SLOT(replayStep(int)));
+    QObject::connect(this->replayTimer, SIGNAL(timeout()), this, SLOT(replayNext()));
+
+    QVBoxLayout *center = new QVBoxLayout;
+    center->addWidget(this->myArea);
+    center->addWidget(this->replayBar);
+
     // set the global layout
     QHBoxLayout *layout = new QHBoxLayout;
     layout->addWidget(this->treeArea);
     layout->addWidget(this->treeButtonArea);
-    layout->addWidget(this->myArea);
+    layout->addLayout(center);
     layout->addWidget(this->textButtonArea);
 
     QVBoxLayout *VLayout = new QVBoxLayout;
@@ -105,6 +148,8 @@ Area::Area(QWidget *parent, QString path) :
     QObject::connect(this->textArea, SIGNAL(textChanged()), this->textArea, SLOT(onTextEdit()));
     QObject::connect(this->saveTextEdit, SIGNAL(clicked()), this, SLOT(saveEdit()));
     QObject::connect(this->textArea, SIGNAL(textChanged()), this, SLOT(onTextEdit()));    
+    QObject::connect(this->textArea, SIGNAL(textChanged()), this, SLOT(validateText()));
+    QObject::connect(this->validator, SIGNAL(validated()), this, SLOT(showDiagnostics()));
     QObject::connect(this, SIGNAL(edition()), this, SLOT(showToolTip()));
     QObject::connect(this, SIGNAL(makeTempXML()), this, SLOT(tempXMLfile()));
 
@@ -277,63 +322,46 @@ void Area::cancelEdit(){
     //Put the last update into the textArea
     this->textArea->setPlainText(this->listOldText->at(a));
 
-    this->saveEdit(1);
+    this->saveEdit();
 
     this->cancelTextEdit->setDefault(false);
     this->cancelTextEdit->setEnabled(false);
 
 }
 
-void Area::saveEdit(int del){
-
-    //temporary file for the text edition
-
-    QFile newph("temp.ph");
-
-    newph.open(QIODevice::WriteOnly | QIODevice::Truncate);
-    QTextStream flux(&newph);
-    flux.setCodec("UTF-8");    
-
-    QString *file = new QString("temp.ph");
-    QString fileXML("tempXML.xml");
-    std::string phFile = file->toStdString();
+void Area::saveEdit(){
 
     try{
 
-        //Save new text into new file
         if(this->textArea->toPlainText().isEmpty()){
 
             throw textAreaEmpty_exception();
         }
 
-        flux << this->textArea->toPlainText() << endl;
-
-        newph.close();        
-
-        if(del == 0){
-
-            emit makeTempXML();
+        // parse the new text, then redraw only what differs from the current model
+        QByteArray content = this->textArea->toPlainText().toUtf8();
+        PHPtr previous = this->myArea->getPHPtr();
+        PHPtr myPHPtr = PHIO::parseContent(content.constData(), content.size());
+        // the items of a path replayed may change
+        this->stopReplay();
+        if(previous){
+            PHDiff diff(*previous, *myPHPtr);
+            TRACE_SCOPE("update model", Trace::isEnabled() ? diff.summary() : string());
+            myPHPtr->render(*previous, diff);
+            this->treeArea->myPHPtr = myPHPtr;
+            this->treeArea->patch(diff);
+        }else{
+            myPHPtr->render();
+            this->treeArea->sortsTree->clear();
+            this->treeArea->sorts.clear();
+            this->treeArea->myPHPtr = myPHPtr;
+            this->treeArea->build();
         }
-
-/*TODO understand why importXMLMetadata after rendering makes actions mad when updating text area... Bug in updating actions ?
-Is it useful to call that method here ? */
-        this->mainWindow->importXMLMetadata(fileXML);
-
-        // render graph
-        PHPtr myPHPtr = PHIO::parseFile(phFile);
         this->myArea->setPHPtr(myPHPtr);
-        myPHPtr->render();
         PHScenePtr scene = myPHPtr->getGraphicsScene();
         this->myArea->setScene(&*scene);
-
-        // delete the current sortsTree and groupsTree
-        this->treeArea->sortsTree->clear();
-        // set the pointer of the treeArea
-        this->treeArea->myPHPtr = myPHPtr;
         //set the pointer of the treeArea
         this->treeArea->myArea = this->myArea;
-        // build the tree in the treeArea
-        this->treeArea->build();
 
         this->indicatorEdit->setVisible(false);       
         this->saveTextEdit->setDefault(false);
@@ -344,8 +372,6 @@ Is it useful to call that method here ? */
         this->cancelTextEdit->setShortcut(QKeySequence());
 
         this->setOldText();
-
-        newph.remove();
     }
     catch(textAreaEmpty_exception & e){
 
@@ -356,36 +382,13 @@ Is it useful to call that method here ? */
         //Catch a parsing error !
         //Put the exception into a QMessageBox critical
 
-        QString phc = "phc";
-        QStringList args;
-        args << "-l" << "dump" << "-i" << QString::fromUtf8(phFile.c_str()) << "--no-debug";
-        QProcess *phcProcess = new QProcess();
-        phcProcess->start(phc, args);
-        if (!phcProcess->waitForStarted())
-            throw pint_program_not_found() << file_info("phc");
-
-        phcProcess->readChannel();
-
-        // read result
-        QByteArray stderr;
-        QByteArray stdout;
-        while (!phcProcess->waitForFinished()) {
-            stderr += phcProcess->readAllStandardError();
-            stdout += phcProcess->readAllStandardOutput();
-        }
-        stderr += phcProcess->readAllStandardError();
-        stdout += phcProcess->readAllStandardOutput();
-        delete phcProcess;
-
-        //Use split function to only keep the line number
-
-        QStringList list = QString(stderr).split('"');
-        QStringList list2 = list[1].split(":");
-        QStringList list3 = list2[0].split(" ");
+        // the parser tells where the error is
+        QString where;
+        if (const string* detail = boost::get_error_info<parse_info>(argh))
+            where = "\n" + QString::fromStdString(*detail);
 
         //One or more of your expressions are wrong !
-        newph.remove();
-        QMessageBox::critical(this, "Syntax error !", "One or more of your expressions are wrong !\nNear "+list3[0]+" "+list3[1]+" of dump");
+        QMessageBox::critical(this, "Syntax error !", "One or more of your expressions are wrong !" + where);
     }
     catch(sort_not_found& sort){
 
@@ -393,6 +396,15 @@ Is it useful to call that method here ? */
 
         QMessageBox::critical(this, "Error !", "Delete the associated actions before the process !");
     }
+    catch(process_not_found& process){
+
+        //Catch a error if an action uses a process the sort does not have
+
+        QString where;
+        if (const int* line = boost::get_error_info<line_info>(process))
+            where = " (line " + QString::number(*line) + ")";
+        QMessageBox::critical(this, "Error !", "An expression uses a process which is not declared" + where + " !");
+    }
 }
 
 void Area::onTextEdit(){
@@ -422,6 +434,89 @@ void Area::onTextEdit(){
     }
 }
 
+void Area::validateText(){
+
+    this->validator->setText(this->textArea->toPlainText());
+}
+
+void Area::showDiagnostics(){
+
+    this->textArea->setDiagnostics(this->validator->getDiagnostics());
+}
+
+void Area::startReplay(const vector<int>& actions){
+
+    this->stopReplay();
+    PHPtr ph = this->myArea->getPHPtr();
+    if (!ph)
+        return;
+    this->replay = boost::make_shared<PHReplay>(ph, actions);
+    this->replaySlider->setRange(0, actions.size());
+    this->replaySlider->setValue(0);
+    this->replayStep(0);
+    this->replayBar->setVisible(true);
+}
+
+void Area::showState(const vector<int>& processes, const QString& title){
+
+    this->stopReplay();
+    PHPtr ph = this->myArea->getPHPtr();
+    if (!ph)
+        return;
+    // a path without any action
+    this->replay = boost::make_shared<PHReplay>(ph, vector<int>(), processes);
+    this->replaySlider->setRange(0, 0);
+    this->replayLabel->setText(title);
+    this->replayBar->setVisible(true);
+}
+
+void Area::replayStep(int step){
+
+    if (!this->replay)
+        return;
+    this->replay->setStep(step);
+    int n = this->replay->countSteps();
+    QString text = QString("step %1/%2").arg(step).arg(n);
+    if (step < n)
+        text += ", next: " + QString::fromStdString(this->replay->describe(step));
+    this->replayLabel->setText(text);
+    if (step == n)
+        this->replayTimer->stop();
+    this->replayPlayButton->setText(this->replayTimer->isActive() ? "Pause" : "Play");
+}
+
+void Area::replayNext(){
+
+    this->replaySlider->setValue(this->replaySlider->value() + 1);
+}
+
+void Area::replayPrevious(){
+
+    this->replaySlider->setValue(this->replaySlider->value() - 1);
+}
+
+void Area::replayPlayOrPause(){
+
+    if (!this->replay || this->replay->countSteps() == 0)
+        return;
+    if (this->replayTimer->isActive()) {
+        this->replayTimer->stop();
+    } else {
+        // from the start once at the end
+        if (this->replaySlider->value() == this->replaySlider->maximum())
+            this->replaySlider->setValue(0);
+        this->replayTimer->start();
+    }
+    this->replayPlayButton->setText(this->replayTimer->isActive() ? "Pause" : "Play");
+}
+
+void Area::stopReplay(){
+
+    this->replayTimer->stop();
+    this->replay.reset();
+    this->replayBar->setVisible(false);
+}
+
 void Area::setOldText(){
 
     this->listOldText->insert(this->textArea->getNberTextChange(), this->textArea->toPlainText());
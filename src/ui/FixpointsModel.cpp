@@ -0,0 +1,76 @@
+#include "FixpointsModel.h"
+
+
+FixpointsModel::FixpointsModel (PHPtr _ph, QObject* parent) : QAbstractTableModel(parent), ph(_ph) {
+    for (int s = 0; s < ph->countSorts(); s++)
+        sorts << QString::fromStdString(ph->getSort(s)->getName());
+    timer.setInterval(200);
+    QObject::connect(&timer, SIGNAL(timeout()), this, SLOT(flush()));
+    timer.start();
+}
+
+
+void FixpointsModel::add (const vector<Fixpoints::State>& fixpoints) {
+    QMutexLocker lock(&mutex);
+    for (const Fixpoints::State& state : fixpoints)
+        pending.insert(pending.end(), state.begin(), state.end());
+}
+
+
+void FixpointsModel::flush (void) {
+    vector<int> added;
+    {
+        QMutexLocker lock(&mutex);
+        added.swap(pending);
+    }
+    if (added.empty() || sorts.isEmpty())
+        return;
+    int count = rowCount();
+    beginInsertRows(QModelIndex(), count, count + added.size() / sorts.size() - 1);
+    rows.insert(rows.end(), added.begin(), added.end());
+    endInsertRows();
+}
+
+
+void FixpointsModel::finish (void) {
+    timer.stop();
+    flush();
+}
+
+
+PHPtr FixpointsModel::getPH (void) { return ph; }
+
+Fixpoints::State FixpointsModel::getState (int row) {
+    vector<int>::const_iterator begin = rows.begin() + row * sorts.size();
+    return Fixpoints::State(begin, begin + sorts.size());
+}
+
+
+int FixpointsModel::rowCount (const QModelIndex& parent) const {
+    return parent.isValid() || sorts.isEmpty() ? 0 : rows.size() / sorts.size();
+}
+
+int FixpointsModel::columnCount (const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : sorts.size();
+}
+
+
+QVariant FixpointsModel::data (const QModelIndex& index, int role) const {
+    if (!index.isValid())
+        return QVariant();
+    int process = rows[index.row() * sorts.size() + index.column()];
+    if (role == Qt::DisplayRole)
+        return process;
+    if (role == Qt::ToolTipRole)
+        return sorts[index.column()] + " " + QString::number(process);
+    if (role == Qt::TextAlignmentRole)
+        return int(Qt::AlignCenter);
+    return QVariant();
+}
+
+
+QVariant FixpointsModel::headerData (int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    return orientation == Qt::Horizontal ? QVariant(sorts[section]) : QVariant(section + 1);
+}
@@ -0,0 +1,162 @@
+#include <QtGui>
+#include "JobsPanel.h"
+
+
+// elapsed time, e.g. "2:05" or "1:02:05"
+static QString duration (qint64 ms) {
+    qint64 s = ms / 1000;
+    QString res = QString("%1:%2").arg((s / 60) % 60).arg(s % 60, 2, 10, QChar('0'));
+    if (s >= 3600)
+        res = QString("%1:%2").arg(s / 3600).arg(res.rightJustified(5, '0'));
+    return res;
+}
+
+
+JobsPanel::JobsPanel (QWidget* parent) : QWidget(parent), shown(0) {
+
+    this->list = new QTreeWidget(this);
+    this->list->setHeaderLabels(QStringList() << "Program" << "Model" << "State" << "Time");
+    this->list->setRootIsDecorated(false);
+    this->list->setSelectionMode(QAbstractItemView::SingleSelection);
+
+    this->output = new QTextEdit(this);
+    this->output->setReadOnly(true);
+    this->output->setFont(QFont("Courier"));
+
+    this->cancelButton = new QPushButton("Cancel", this);
+    this->cancelButton->setEnabled(false);
+    this->clearButton = new QPushButton("Clear finished", this);
+
+    QHBoxLayout* buttons = new QHBoxLayout;
+    buttons->addWidget(this->cancelButton);
+    buttons->addWidget(this->clearButton);
+    buttons->addStretch();
+
+    QVBoxLayout* left = new QVBoxLayout;
+    left->addWidget(this->list);
+    left->addLayout(buttons);
+
+    QHBoxLayout* layout = new QHBoxLayout;
+    layout->addLayout(left, 1);
+    layout->addWidget(this->output, 2);
+    this->setLayout(layout);
+
+    QObject::connect(this->list, SIGNAL(itemSelectionChanged()), this, SLOT(selectionChanged()));
+    QObject::connect(this->cancelButton, SIGNAL(clicked()), this, SLOT(cancelSelected()));
+    QObject::connect(this->clearButton, SIGNAL(clicked()), this, SLOT(clearDone()));
+
+    // elapsed time of the running jobs
+    this->timer.setInterval(1000);
+    QObject::connect(&this->timer, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+
+void JobsPanel::addJob (AnalysisJob* job) {
+    job->setParent(this);
+    QTreeWidgetItem* item = new QTreeWidgetItem(this->list);
+    item->setToolTip(0, job->getProgram() + " " + job->getArguments().join(" "));
+    this->items.insert(job, item);
+    this->updateItem(item, job);
+    QObject::connect(job, SIGNAL(output(QString, bool)), this, SLOT(jobOutput(QString, bool)));
+    QObject::connect(job, SIGNAL(stateChanged()), this, SLOT(jobStateChanged()));
+    this->list->setCurrentItem(item);
+    this->timer.start();
+}
+
+
+int JobsPanel::countRunning (void) {
+    int res = 0;
+    for (AnalysisJob* job : this->items.keys())
+        if (job->isRunning())
+            res++;
+    return res;
+}
+
+
+AnalysisJob* JobsPanel::selected (void) {
+    QList<QTreeWidgetItem*> s = this->list->selectedItems();
+    return s.isEmpty() ? NULL : this->items.key(s.first(), NULL);
+}
+
+
+void JobsPanel::updateItem (QTreeWidgetItem* item, AnalysisJob* job) {
+    item->setText(0, job->getProgram());
+    item->setText(1, QFileInfo(job->getModel()).fileName());
+    item->setToolTip(1, job->getModel());
+    QString state = AnalysisJob::stateName(job->getState());
+    if (job->getState() == AnalysisJob::Failed && job->getExitCode() != 0)
+        state += " (" + QString::number(job->getExitCode()) + ")";
+    item->setText(2, state);
+    item->setText(3, duration(job->getElapsed()));
+}
+
+
+void JobsPanel::jobOutput (QString text, bool error) {
+    AnalysisJob* job = (AnalysisJob*) sender();
+
+    // the output shown when the job was selected may already hold the text, or its beginning
+    int end = this->received[job] += text.size();
+    if (job != this->selected() || end <= this->shown)
+        return;
+    text = text.right(end - this->shown);
+    this->shown = end;
+    QTextCursor cursor(this->output->document());
+    cursor.movePosition(QTextCursor::End);
+    QTextCharFormat format;
+    format.setForeground(error ? QColor(180, 20, 20) : this->palette().color(QPalette::Text));
+    cursor.insertText(text, format);
+    this->output->setTextCursor(cursor);
+}
+
+
+void JobsPanel::jobStateChanged (void) {
+    AnalysisJob* job = (AnalysisJob*) sender();
+    this->updateItem(this->items.value(job), job);
+    if (job == this->selected())
+        this->cancelButton->setEnabled(job->isRunning() && job->getState() != AnalysisJob::Cancelled);
+    if (!job->isRunning())
+        emit jobDone(job);
+}
+
+
+void JobsPanel::selectionChanged (void) {
+    AnalysisJob* job = this->selected();
+    this->output->clear();
+    this->cancelButton->setEnabled(job != NULL && job->isRunning() && job->getState() != AnalysisJob::Cancelled);
+    if (job == NULL)
+        return;
+    // the output written so far, the rest is appended as it comes
+    QString text = job->getOutput();
+    this->shown = text.size();
+    this->output->setPlainText(text);
+    this->output->moveCursor(QTextCursor::End);
+}
+
+
+void JobsPanel::cancelSelected (void) {
+    AnalysisJob* job = this->selected();
+    if (job != NULL)
+        job->cancel();
+}
+
+
+void JobsPanel::clearDone (void) {
+    for (AnalysisJob* job : this->items.keys())
+        if (!job->isRunning()) {
+            delete this->items.take(job);
+            this->received.remove(job);
+            job->deleteLater();
+        }
+}
+
+
+void JobsPanel::tick (void) {
+    bool running = false;
+    for (QMap<AnalysisJob*, QTreeWidgetItem*>::iterator i = this->items.begin(); i != this->items.end(); ++i)
+        if (i.key()->isRunning()) {
+            this->updateItem(i.value(), i.key());
+            running = true;
+        }
+    if (!running)
+        this->timer.stop();
+}
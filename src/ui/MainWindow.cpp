@@ -4,14 +4,21 @@
 #include "PHIO.h"
 #include "Exceptions.h"
 #include "Area.h"
+#include "ModelLoader.h"
+#include "AnalysisJob.h"
+#include "JobsPanel.h"
+#include "Fixpoints.h"
+#include "FixpointsModel.h"
+#include "LocalCausality.h"
+#include "Reachability.h"
+#include "Trace.h"
 #include <stdio.h>
 #include <qthread.h>
 #include <iostream>
 #include "IO.h"
 #include <QThread>
 #include <sstream>
-#include <time.h> 
-#include <fstream>
+#include <algorithm>
 
 MainWindow* MainWindow::mwThis;
 
@@ -20,6 +27,10 @@ MainWindow::MainWindow()
     // static variable
     MainWindow::mwThis = this;
 
+    // no file is being loaded
+    loaded = 0;
+    loadingDialog = NULL;
+
     //arguments type list of new function
     ConnectionSettings::argTypeList= QStringList() << "Text" << "Integer" << "Real" << "Boolean" << "Process Sequence" << "Process Set" << "File .ph" << "File" << "Folder" << "Choice" << "File not existing" << "Argument" << "Current File";
 
@@ -178,8 +189,44 @@ MainWindow::MainWindow()
 
     actionConnection->setShortcut(    QKeySequence(Qt::CTRL + Qt::Key_C));
 
+    // the analysis jobs, at the bottom of the window
+    jobsPanel = new JobsPanel(this);
+    jobsDock = new QDockWidget("Jobs", this);
+    jobsDock->setObjectName("jobsDock");
+    jobsDock->setWidget(jobsPanel);
+    addDockWidget(Qt::BottomDockWidgetArea, jobsDock);
+    jobsDock->hide();
+    menuWindow->addSeparator();
+    menuWindow->addAction(jobsDock->toggleViewAction());
+    QObject::connect(jobsPanel, SIGNAL(jobDone(AnalysisJob*)), this, SLOT(jobDone(AnalysisJob*)));
+
+    // the fixpoints found, in a tab next to the jobs
+    fixpointsView = new QTableView(this);
+    fixpointsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    fixpointsView->setSelectionMode(QAbstractItemView::SingleSelection);
+    fixpointsDock = new QDockWidget("Fixpoints", this);
+    fixpointsDock->setObjectName("fixpointsDock");
+    fixpointsDock->setWidget(fixpointsView);
+    addDockWidget(Qt::BottomDockWidgetArea, fixpointsDock);
+    tabifyDockWidget(jobsDock, fixpointsDock);
+    fixpointsDock->hide();
+    menuWindow->addAction(fixpointsDock->toggleViewAction());
+    QObject::connect(fixpointsView, SIGNAL(clicked(QModelIndex)), this, SLOT(showFixpoint(QModelIndex)));
+
     // action for the menu Help
     actionHelp = menuHelp->addAction("Help !");
+    menuHelp->addSeparator();
+    menuTimings = menuHelp->addMenu("Timings");
+    actionRecordTimings = menuTimings->addAction("Record timings");
+    actionShowTimings = menuTimings->addAction("Summary...");
+    actionExportTimings = menuTimings->addAction("Export as Chrome trace...");
+    actionRecordTimings->setCheckable(true);
+    actionRecordTimings->setChecked(Trace::isEnabled());
+
+    // connect the menu Help
+    QObject::connect(actionRecordTimings, SIGNAL(toggled(bool)), this, SLOT(recordTimings(bool)));
+    QObject::connect(actionShowTimings, SIGNAL(triggered()), this, SLOT(showTimings()));
+    QObject::connect(actionExportTimings, SIGNAL(triggered()), this, SLOT(exportTimings()));
 
     // disable what does not work well
     actionHelp->setEnabled(false);
@@ -246,115 +293,213 @@ std::vector<QString> MainWindow::getAllPaths() {
 }
 
 
-// open a new tab
-MyArea* MainWindow::openTab() {
+// open new tabs
+void MainWindow::openTab() {
 
-        // OpenFile dialog
-        QFileDialog* filedialog = new QFileDialog(this);
+    // OpenFile dialog, several files may be selected
+    QStringList files = QFileDialog::getOpenFileNames(this, "Open...");
+    openFiles(files);
+}
 
-        QDialog* mb = new QDialog(filedialog);
-        mb->setFixedSize(300,150);
-        mb->setWindowFlags(Qt::Window | Qt::WindowTitleHint | Qt::CustomizeWindowHint);
 
-        QString file = filedialog->getOpenFileName(this, "Open...");
+// load files in the background, each tab is made as soon as its model is ready
+void MainWindow::openFiles(const QStringList& files) {
 
-        // TODO refactor using early returns
-        if(file!=NULL) {
-     // Initiates timeopening calculation
-     std::ofstream logFile("log_opening_time.txt",std::ios::app);
-     timespec depart, arrivee;
-     clock_gettime(CLOCK_REALTIME,&depart);
-            QFileInfo pathInfo(file);
-            std::vector<QString> allPath = this->getAllPaths();
-            int size = allPath.size();
-            bool alreadyOpen = false;
+    std::vector<QString> allPath = this->getAllPaths();
+    QStringList alreadyOpen;
 
-            // check if the file is already open
-            for(int i=0;i<size;i++) {
-                if(allPath[i]==file) {
-                   alreadyOpen = true;
-                    break;
-                }
-            }
+    for (const QString &file : files) {
 
+        // check if the file is already open, or being opened
+        QString path = QFileInfo(file).absoluteFilePath();
+        bool open = std::find(allPath.begin(), allPath.end(), path) != allPath.end();
+        for (ModelLoader* loader : loading.keys())
+            open = open || loader->getPath() == path;
+        if (open) {
+            alreadyOpen << QFileInfo(file).fileName();
+            continue;
+        }
+
+        // parsing and layout are run by the pool of the loaders
+        ModelLoader* loader = new ModelLoader(path, this);
+        loading.insert(loader, ModelLoader::Reading);
+        QObject::connect(loader, SIGNAL(progress(int)), this, SLOT(loadingProgress(int)));
+        QObject::connect(loader, SIGNAL(finished()), this, SLOT(loadingFinished()));
+        QObject::connect(loader, SIGNAL(failed(QString)), this, SLOT(loadingFailed(QString)));
+        QObject::connect(loader, SIGNAL(cancelled()), this, SLOT(loadingCancelled()));
+        loader->start();
+    }
+    updateLoadingDialog();
+
+    if (!alreadyOpen.isEmpty())
+        QMessageBox::critical(this, "Error", "This file is already opened!\n" + alreadyOpen.join("\n"));
+}
 
-            if(!alreadyOpen){
-
-                //Display loading window
-                QLabel* dialogue = new QLabel(mb);
-                mb->setWindowTitle("Please wait...");
-                QMovie* gif = new QMovie("loading.gif");
-                gif->setScaledSize(QSize(300,150));
-                gif->start();
-                dialogue->setMovie(gif);
-                dialogue->show();
-                mb->open();
-
-                //need a std::string instead of a QString
-                std::string path =	file.toStdString();                
-
-                // parse file
-                Area *area = new Area(this, QString::fromStdString(path));
-                area->mainWindow = this;
-
-                try {
-                    // render graph
-                    PHPtr myPHPtr = PHIO::parseFile(path);
-                    area->myArea->setPHPtr(myPHPtr);
-                    myPHPtr->render();
-                    PHScenePtr scene = myPHPtr->getGraphicsScene();
-                    area->myArea->setScene(&*scene);
-
-                    // set the pointer of the treeArea
-                    area->treeArea->myPHPtr = myPHPtr;
-                    //set the pointer of the treeArea
-                    area->treeArea->myArea = area->myArea;
-                    // build the tree in the treeArea
-                    area->treeArea->build();
-
-                    // call the PH file and write it in the text area (same as .ph)
-                    QFile fichier(file);
-                    fichier.open(QIODevice::ReadOnly);
-                    QByteArray data;
-                    data = fichier.readAll();
-                    QString ligne(data);
-                    area->textArea->setPlainText(ligne);
-
-                    // make the subwindow for the new tab
-                    QMdiSubWindow *theNewTab = this->getCentraleArea()->addSubWindow(area);
-                    QString fileName(pathInfo.fileName());
-                    theNewTab->setWindowTitle(fileName);
-                    this->enableMenu();                    
-
-                    mb->close();
-                    this->setWindowState(Qt::WindowMaximized);
-            // putting time needed to open ph file into a "log_opening_time.txt" file
-            clock_gettime(CLOCK_REALTIME,&arrivee);
-            double timeOpening;
-            timeOpening = (arrivee.tv_nsec - depart.tv_nsec)/1000000.0+(arrivee.tv_sec - depart.tv_sec)*1000.0;
-            logFile << file.toStdString()+"-----"+"-----" << timeOpening;
-                    logFile << " ms\n";
-                    logFile.close();
-                    return area->myArea;
-
-                } catch(exception_base& argh) {
-                    mb->close();
-                    QMessageBox::critical(this, "Error", "Extension not recognized. Only ph files are accepted.");
-                    return NULL;
-                }
-            }
-            else {
-                mb->close();
-                QMessageBox::critical(this, "Error", "This file is already opened!");
-                return NULL;
-            }
 
+// a loading stage starts
+void MainWindow::loadingProgress(int stage) {
+    ModelLoader* loader = (ModelLoader*) sender();
+    if (!loading.contains(loader) || loader->isCancelled())
+        return;
+    loading[loader] = stage;
+    updateLoadingDialog();
+}
 
 
-        } else {
-            mb->close();
-            return NULL;
+// the model is parsed and laid out: draw it in a new tab
+void MainWindow::loadingFinished() {
+
+    ModelLoader* loader = (ModelLoader*) sender();
+    try {
+        addTab(loader->getPath(), loader->getPH(), loader->getLayout(), loader->getText());
+        this->setWindowState(Qt::WindowMaximized);
+
+        // whole opening, from the worker thread to the tab
+        if (Trace::isEnabled())
+            Trace::record("open file", loader->getStartTime(), loader->getPath().toStdString());
+
+    } catch(exception_base& argh) {
+        QMessageBox::critical(this, "Error", "Extension not recognized. Only ph files are accepted.");
+    }
+    closeLoading(loader);
+}
+
+
+// draw a model in a new tab
+Area* MainWindow::addTab(const QString& path, PHPtr myPHPtr, const QList<GVNode>& layout, const QString& text) {
+
+    QFileInfo pathInfo(path);
+    Area *area = new Area(this, path);
+    area->mainWindow = this;
+
+    try {
+        // render graph, the layout is already done
+        area->myArea->setPHPtr(myPHPtr);
+        myPHPtr->render(layout);
+        PHScenePtr scene = myPHPtr->getGraphicsScene();
+        area->myArea->setScene(&*scene);
+
+        // set the pointer of the treeArea
+        area->treeArea->myPHPtr = myPHPtr;
+        //set the pointer of the treeArea
+        area->treeArea->myArea = area->myArea;
+        // build the tree in the treeArea
+        area->treeArea->build();
+
+        // write the PH file in the text area
+        area->textArea->setPlainText(text);
+
+    } catch(exception_base& argh) {
+        delete area;
+        throw;
+    }
+
+    // make the subwindow for the new tab
+    QMdiSubWindow *theNewTab = this->getCentraleArea()->addSubWindow(area);
+    theNewTab->setWindowTitle(pathInfo.fileName());
+    theNewTab->show();
+    this->getCentraleArea()->setActiveSubWindow(theNewTab);
+    this->enableMenu();
+    return area;
+}
+
+
+// the model could not be loaded
+void MainWindow::loadingFailed(QString message) {
+    ModelLoader* loader = (ModelLoader*) sender();
+    QString file = QFileInfo(loader->getPath()).fileName();
+    closeLoading(loader);
+    QMessageBox::critical(this, "Error", file + ": " + message);
+}
+
+
+// the user cancelled the loading
+void MainWindow::loadingCancelled() {
+    closeLoading((ModelLoader*) sender());
+}
+
+
+// cancel all the files being loaded
+void MainWindow::cancelLoading() {
+    for (ModelLoader* loader : loading.keys())
+        loader->cancel();
+}
+
+
+// forget a loader once it is done
+void MainWindow::closeLoading(ModelLoader* loader) {
+    if (loading.remove(loader) > 0)
+        loaded++;
+    loader->deleteLater();
+    updateLoadingDialog();
+}
+
+
+// progress of all the files being loaded, which may be cancelled
+void MainWindow::updateLoadingDialog() {
+
+    // nothing left to load
+    if (loading.isEmpty()) {
+        if (loadingDialog != NULL) {
+            loadingDialog->close();
+            loadingDialog->deleteLater();
+            loadingDialog = NULL;
         }
+        loaded = 0;
+        return;
+    }
+
+    if (loadingDialog == NULL) {
+        loadingDialog = new QProgressDialog("", "Cancel", 0, 1, this);
+        loadingDialog->setWindowTitle("Opening...");
+        loadingDialog->setWindowModality(Qt::WindowModal);
+        loadingDialog->setMinimumDuration(300);
+        loadingDialog->setAutoClose(false);
+        loadingDialog->setAutoReset(false);
+        QObject::connect(loadingDialog, SIGNAL(canceled()), this, SLOT(cancelLoading()));
+    }
+
+    // each file counts for its stages, files already done for all of them
+    int total = loading.size() + loaded;
+    int value = loaded * ModelLoader::StageCount;
+    for (int stage : loading.values())
+        value += stage;
+    loadingDialog->setMaximum(total * ModelLoader::StageCount);
+    loadingDialog->setValue(value);
+    if (total == 1)
+        loadingDialog->setLabelText(QFileInfo(loading.begin().key()->getPath()).fileName() + ": " + ModelLoader::stageName(loading.begin().value()));
+    else
+        loadingDialog->setLabelText(QString::number(loaded) + " of " + QString::number(total) + " files opened");
+}
+
+
+// start / stop recording how long each phase takes
+void MainWindow::recordTimings(bool onOff) {
+    Trace::setEnabled(onOff);
+}
+
+
+// durations of the phases recorded so far
+void MainWindow::showTimings() {
+    if (Trace::count() == 0) {
+        QMessageBox::information(this, "Timings", "No timing recorded: check Help > Timings > Record timings, then open a file.");
+        return;
+    }
+    QMessageBox box(QMessageBox::Information, "Timings", "Time spent in each phase, longest first.", QMessageBox::Ok, this);
+    box.setDetailedText(Trace::summary());
+    box.exec();
+}
+
+
+// save the recorded phases, to be viewed in chrome://tracing
+void MainWindow::exportTimings() {
+    QString file = QFileDialog::getSaveFileName(this, "Export timings", QString(), "*.json");
+    if (file.isEmpty())
+        return;
+    if (file.indexOf(QString(".json"), 0, Qt::CaseInsensitive) < 0)
+        file += ".json";
+    if (!Trace::writeChromeTrace(file))
+        QMessageBox::critical(this, "Error", "Cannot write " + file);
 }
 
 
@@ -381,8 +526,12 @@ void MainWindow::save() {
 
         if(!((Area*) subWindow->widget())->indicatorEdit->isVisible()){
 
-        // SaveFile dialog
-        QString fichier = QFileDialog::getSaveFileName(this, "Save file", "*.ph");
+        // SaveFile dialog, files are compressed with gzip if their name ends with .gz
+        QString compressedFilter = "Compressed PH files (*.ph.gz)";
+        QString filter;
+        QString fichier = QFileDialog::getSaveFileName(this, "Save file", "*.ph", "PH files (*.ph);;" + compressedFilter, &filter);
+        if (filter == compressedFilter && !fichier.isEmpty() && !fichier.endsWith(".gz"))
+            fichier += ".gz";
 
         // need a std::string instead of a QString
         std::string path =	fichier.toStdString();
@@ -399,13 +548,21 @@ void MainWindow::save() {
         if(ok && typeFile == "Dump"){
 
             PHPtr ph = ((Area*) subWindow->widget())->myArea->getPHPtr();
-            PHIO::writeToFile (path, ph);
+            try {
+                PHIO::writeToFile (path, ph);
+            } catch (io_error&) {
+                QMessageBox::critical(this, "Error", "Sorry, unable to write file.");
+            }
         }
         //Text format (QTextEdit)
         else if(ok && typeFile == "Standard"){
 
             std::string ph = ((Area*) subWindow->widget())->textArea->toPlainText().toStdString();
-            IO::writeFile (path, ph);
+            try {
+                IO::writeFile (path, ph);
+            } catch (io_error&) {
+                QMessageBox::critical(this, "Error", "Sorry, unable to write file.");
+            }
         }
 
         }else{
@@ -448,25 +605,21 @@ void MainWindow::exportDot() {
         // SaveFile dialog
         QString fichier = QFileDialog::getSaveFileName(this, "Export as .dot file", QString(), "*.dot");
 
+        if (fichier.isEmpty())
+            return;
+
         // add .dot to the name if necessary
         if (fichier.indexOf(QString(".dot"), 0, Qt::CaseInsensitive) < 0){
             fichier += ".dot";
         }
 
-        // need the String file of the Dot
-        QString str= QString::fromStdString(((Area*) subWindow->widget())->myArea->getPHPtr()->toDotString());
-
-        QFile file(fichier);
-        if (!file.open(QIODevice::WriteOnly)){
+        // plain text streamed to the file (a QDataStream would prefix it with its length, in UTF-16)
+        try {
+            PHIO::writeDotToFile(fichier.toStdString(), ((Area*) subWindow->widget())->myArea->getPHPtr());
+        } catch (io_error&) {
             QMessageBox::critical(this, "Error", "Sorry, unable to open file.");
-            file.errorString();
             return;
         }
-        else{
-            QDataStream out(&file);
-            out.setVersion(QDataStream::Qt_4_5);
-            out << str;
-        }
 
     } else QMessageBox::critical(this, "Error", "No file opened!");
 
@@ -516,6 +669,7 @@ void MainWindow::importXMLMetadata(QString tempXML){
             xmlfile = tempXML;
         }
 
+        TRACE_SCOPE("import XML", xmlfile.toStdString());
         QFile input(xmlfile);
 
         QXmlStreamReader stream(&input) ;
@@ -615,6 +769,7 @@ void MainWindow::importXMLMetadata(QString tempXML){
                 while (stream.name()=="sort")
                 {
                     std::string sortname = stream.attributes().first().value().toString().toStdString();
+                    GSortPtr gsort = myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname);
                     stream.readNext();
                     while (stream.isStartElement()==false)
                     {
@@ -627,22 +782,22 @@ void MainWindow::importXMLMetadata(QString tempXML){
                         // Getting x coordinate of the top left corner of the sort
                         qreal posx = stream.attributes().first().value().toString().toDouble();
                         // Setting the x coordinate to the new value
-                        myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname)->setX(posx);
+                        gsort->setX(posx);
 
                         // Getting y coordinate of the top left corner of the sort
                         qreal posy = stream.attributes().value("y").toString().toDouble();
                         // Setting the y coordinate to the new value
-                        myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname)->setY(posy);
+                        gsort->setY(posy);
 
                         // Getting x coordinate of the cluster of the sort
                         qreal posxCluster = stream.attributes().value("xcluster").toString().toDouble();
                         // Setting the x coordinate to the new value
-                        myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname)->getLeftTopCornerPoint()->setX(posxCluster);
+                        gsort->getLeftTopCornerPoint()->setX(posxCluster);
 
                         // Getting y coordinate of the cluster of the sort
                         qreal posyCluster = stream.attributes().value("ycluster").toString().toDouble();
                         // Setting the y coordinate to the new value
-                        myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname)->getLeftTopCornerPoint()->setY(posyCluster);
+                        gsort->getLeftTopCornerPoint()->setY(posyCluster);
 
                         stream.readNext();
                         while (stream.isStartElement()==false)
@@ -662,7 +817,7 @@ void MainWindow::importXMLMetadata(QString tempXML){
                     if (stream.name()=="color")
                     {
                         QString color = stream.readElementText();
-                        myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname)->getRect()->setBrush(QBrush(QColor(color)));
+                        gsort->getRect()->setBrush(QBrush(QColor(color)));
                         stream.readNext();
                         while (stream.isStartElement()==false)
                         {
@@ -716,21 +871,18 @@ void MainWindow::importXMLMetadata(QString tempXML){
 
                             if (stream.name()=="pos")
                             {
-                                for (ProcessPtr &b : myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname)->getSort()->getProcesses()){
-                                    if (b->getNumber()==noprocess)
-                                    {
-                                        // Getting x coordinate of the center of the process
-                                        qreal posx = stream.attributes().value("x").toString().toDouble();
-                                        // Setting the x coordinate to the new value
-                                        b->getGProcess()->getCenterPoint()->setX(posx);
-
-                                        // Getting y coordinate of the center of the process
-                                        qreal posy = stream.attributes().value("y").toString().toDouble();
-                                        // Setting the y coordinate to the new value
-                                        b->getGProcess()->getCenterPoint()->setY(posy);
+                                ProcessPtr b = gsort->getSort()->getProcess(noprocess);
+
+                                // Getting x coordinate of the center of the process
+                                qreal posx = stream.attributes().value("x").toString().toDouble();
+                                // Setting the x coordinate to the new value
+                                b->getGProcess()->getCenterPoint()->setX(posx);
+
+                                // Getting y coordinate of the center of the process
+                                qreal posy = stream.attributes().value("y").toString().toDouble();
+                                // Setting the y coordinate to the new value
+                                b->getGProcess()->getCenterPoint()->setY(posy);
 //TODO delete that useless method everywhere //b->getGProcess()->setCoordsForImport(nodeX,nodeY);
-                                    }
-                                }
 
                                 stream.readNext();
                                 while (stream.isStartElement()==false)
@@ -759,7 +911,7 @@ void MainWindow::importXMLMetadata(QString tempXML){
                         QGraphicsSceneMouseEvent* event = new QGraphicsSceneMouseEvent();
                         event->scenePos().setX(0.1);
                         event->scenePos().setY(0.1);
-                        myarea->getPHPtr()->getGraphicsScene()->getGSort(sortname)->mouseReleaseEvent(event);
+                        gsort->mouseReleaseEvent(event);
                     }
                     i++;
                 }
@@ -962,12 +1114,12 @@ void MainWindow::changeSortColor() {
     // get the widget in the central area
     Area* view = (Area*) this->getCentraleArea()->currentSubWindow()->widget();
     // get the map of all the gsorts in the myArea, related to the name of the sorts
-    map<string, GSortPtr> sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
+    const map<string, GSortPtr>& sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
 
     if (!color.isValid()) {
         return ;
     } else {
-        map<string, GSortPtr>::iterator it;
+        map<string, GSortPtr>::const_iterator it;
         for(it=sortList.begin(); it!=sortList.end(); it++) {
             // for all the GSort in the map, set the brush
             it->second->getRect()->setBrush(QBrush(QColor(color)));
@@ -981,22 +1133,22 @@ void MainWindow::positiveContrast() {
     // get the widget in the central area
     Area* view = (Area*) this->getCentraleArea()->currentSubWindow()->widget();
     // get the map of all the gsorts
-    map<string, GSortPtr> sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
+    const map<string, GSortPtr>& sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
 
     // set the background color to white
     view->myArea->getPHPtr()->getGraphicsScene()->setBackgroundBrush(QColor(255,255,255));
 
     // set the sorts brush to dark
-    map<string, GSortPtr>::iterator it;
+    map<string, GSortPtr>::const_iterator it;
     for(it=sortList.begin(); it!=sortList.end(); it++) {
         it->second->getRect()->setPen(QPen(QColor(0,51,102)));
         it->second->getRect()->setBrush(QBrush(QColor(0,51,102)));
     }
 
     // get all the processes of the PH scene
-    std::vector<GProcessPtr> processes = view->myArea->getPHPtr()->getGraphicsScene()->getProcesses();
+    const std::vector<GProcessPtr>& processes = view->myArea->getPHPtr()->getGraphicsScene()->getProcesses();
     // set the color ellipse to transparent
-    for (GProcessPtr &a: processes){
+    for (const GProcessPtr &a: processes){
         a->getEllipseItem()->setPen(QPen(Qt::black, 1));
         a->getEllipseItem()->setBrush(QBrush(QColor(220,220,220)));
     }
@@ -1008,21 +1160,21 @@ void MainWindow::negativeContrast() {
     // get the widget in the central area
     Area* view = (Area*) this->getCentraleArea()->currentSubWindow()->widget();
     // get the map of all the gsorts associated to their names
-    map<string, GSortPtr> sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
+    const map<string, GSortPtr>& sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
 
     // set the background color to dark grey
     view->myArea->getPHPtr()->getGraphicsScene()->setBackgroundBrush(QColor(31,31,31));
 
     // set the sorts brush to clear
-    map<string, GSortPtr>::iterator it;
+    map<string, GSortPtr>::const_iterator it;
     for(it = sortList.begin(); it != sortList.end(); it++) {
         it->second->getRect()->setPen(QPen(QColor(7,54,66)));
         it->second->getRect()->setBrush(QBrush(QColor(100,100,100)));
     }
     // get all the processes of the PH scene
-    std::vector<GProcessPtr> processes = view->myArea->getPHPtr()->getGraphicsScene()->getProcesses();
+    const std::vector<GProcessPtr>& processes = view->myArea->getPHPtr()->getGraphicsScene()->getProcesses();
     // set the color ellipse to transparent
-    for (GProcessPtr &a: processes){
+    for (const GProcessPtr &a: processes){
         a->getEllipseItem()->setPen(QPen(Qt::black, 1));
         a->getEllipseItem()->setBrush(QBrush(QColor(160,160,160)));
     }
@@ -1034,22 +1186,22 @@ void MainWindow::printStyle() {
     // get the widget in the central area
     Area* view = (Area*) this->getCentraleArea()->currentSubWindow()->widget();
     // get the map of all the gsorts associated to their names
-    map<string, GSortPtr> sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
+    const map<string, GSortPtr>& sortList = view->myArea->getPHPtr()->getGraphicsScene()->getGSorts();
 
     // set the background color to white
     view->myArea->getPHPtr()->getGraphicsScene()->setBackgroundBrush(Qt::white);
 
     // set the brush color to black
-    map<string, GSortPtr>::iterator it;
+    map<string, GSortPtr>::const_iterator it;
     for(it = sortList.begin(); it != sortList.end(); it++) {
         it->second->getRect()->setPen(QPen(Qt::black, 4));
         it->second->getRect()->setBrush(Qt::NoBrush);
     }
 
     // get all the processes of the PH scene
-    std::vector<GProcessPtr> processes = view->myArea->getPHPtr()->getGraphicsScene()->getProcesses();
+    const std::vector<GProcessPtr>& processes = view->myArea->getPHPtr()->getGraphicsScene()->getProcesses();
     // set the color ellipse to transparent
-    for (GProcessPtr &a: processes){
+    for (const GProcessPtr &a: processes){
         a->getEllipseItem()->setPen(QPen(Qt::black, 3));
         a->getEllipseItem()->setBrush(Qt::NoBrush);
     }
@@ -1088,107 +1240,172 @@ void MainWindow::hideShowTree(){
     view->hideOrShowTree();
 }
 
-// main method for the computation menu
+// main method for the computation menu: the program runs in the background, in the jobs panel
 void MainWindow::compute(QString program, QStringList arguments, QString fileName) {
 
-    // start process
-    QProcess *myProcess = new QProcess();
-
-    myProcess->start(program, arguments);
+    // the model analysed, for the panel
+    if (fileName.isEmpty() && this->getCentraleArea()->currentSubWindow() != 0)
+        fileName = this->pathCurrentWindow();
 
-    if (!myProcess->waitForStarted())
-        throw pint_program_not_found() << file_info("phc");
-
-    // read result
-    QByteArray err;
-    QByteArray out;
-    while (!myProcess->waitForFinished()) {
-        err += myProcess->readAllStandardError();
-        out += myProcess->readAllStandardOutput();
-    }
-    err += myProcess->readAllStandardError();
-    out += myProcess->readAllStandardOutput();
-    delete myProcess;
+    AnalysisJob* job = new AnalysisJob(program, arguments, fileName);
+    this->jobsPanel->addJob(job);
+    this->jobsDock->show();
+    this->jobsDock->raise();
+    job->start();
+}
 
-    // pop up for the errors
-    if(!err.isEmpty()){
+// tells the user that a job is over
+void MainWindow::jobDone(AnalysisJob* job) {
+    QString message = job->getProgram() + " " + AnalysisJob::stateName(job->getState()).toLower();
+    if (!job->getModel().isEmpty())
+        message += " on " + QFileInfo(job->getModel()).fileName();
+    this->statusBar()->showMessage(message, 10000);
+}
 
-        //correct a false error message for ph-stable
-        if(program==QString("ph-stable")) {
-            if( !(QString(err).contains(fileName)) || fileName.isEmpty() ) {
-                QMessageBox::critical(this, program+".error", err);
-            }
-        } else {
-            //correct a false error message for ph-exec
-            if(program!=QString("ph-exec")) {
-                QMessageBox::critical(this, program+".error", err);
-            }
+// highlights a fixpoint in the tab of its model
+void MainWindow::showFixpoint(const QModelIndex& index) {
+    FixpointsModel* model = (FixpointsModel*) this->fixpointsView->model();
+    if (!index.isValid() || model == NULL)
+        return;
+    // an edit makes a new PH, the fixpoints are then those of the previous one
+    for (QMdiSubWindow* subWindow : this->getCentraleArea()->subWindowList()) {
+        Area* area = (Area*) subWindow->widget();
+        if (area->myArea->getPHPtr() == model->getPH()) {
+            this->getCentraleArea()->setActiveSubWindow(subWindow);
+            area->showState(model->getState(index.row()), QString("fixpoint %1").arg(index.row() + 1));
+            return;
         }
     }
-
-    //pop up for the output
-    if(!out.isEmpty()){
-
-        QMessageBox::information(this, program+".output", out);
-
-    }
-
-
+    this->statusBar()->showMessage("The model of these fixpoints was closed or edited since", 10000);
 }
 
-void MainWindow::findFixpoints() {
-
-    QString program = "ph-stable";
-    QStringList arguments;
 
-    // get the filename associated with the current subWindow
-    QString fileName;
-    if(this->getCentraleArea()->currentSubWindow() != 0) {
-        QMdiSubWindow *subWindow = this->getCentraleArea()->currentSubWindow();
-        fileName = ((Area*) subWindow->widget())->path;
-    } else {
-        fileName = "";
-    }
-
-    // give the arguments
-    arguments << "--no-debug" << "-i" << fileName;
+// enumerates the fixpoints of the model of the current tab (as edited), in the background
+void MainWindow::findFixpoints() {
 
-    // call MainWindow::compute
-    this->compute(program, arguments, fileName);
+    if(this->getCentraleArea()->currentSubWindow() == 0)
+        return;
+    Area* area = (Area*) this->getCentraleArea()->currentSubWindow()->widget();
+    PHPtr ph = area->myArea->getPHPtr();
+    if (!ph)
+        return;
+
+    // the rows are added from the threads of the search, the model belonging to the job
+    boost::shared_ptr<Fixpoints> engine = boost::make_shared<Fixpoints>(*ph);
+    FixpointsModel* model = new FixpointsModel(ph);
+    AnalysisJob::Task task = [engine, model] (AnalysisJob& job) -> int {
+        Fixpoints::Result r = engine->run([model] (const vector<Fixpoints::State>& found) { model->add(found); }
+            , Fixpoints::Options(), [&job] () { return job.isCancelRequested(); });
+        job.write(QString("%1 fixpoints, %2 choices, %3 ms\n").arg(r.fixpoints).arg(r.nodes).arg(r.elapsed));
+        if (!r.complete && !job.isCancelRequested())
+            job.write("too many fixpoints, the search stopped\n", true);
+        return r.complete ? 0 : 1;
+    };
+
+    AnalysisJob* job = new AnalysisJob("fixpoints", task, area->path);
+    model->setParent(job);
+    job->setCallback([model] (AnalysisJob&) { model->finish(); });
+    QItemSelectionModel* selection = this->fixpointsView->selectionModel();
+    this->fixpointsView->setModel(model);
+    delete selection;
+    this->fixpointsDock->setWindowTitle(area->path.isEmpty() ? "Fixpoints" : "Fixpoints of " + QFileInfo(area->path).fileName());
+    this->jobsPanel->addJob(job);
+    this->jobsDock->show();
+    this->fixpointsDock->show();
+    this->fixpointsDock->raise();
+    job->start();
 }
 
 
+// explores the states of the model of the current tab (as edited), in the background
 void MainWindow::computeReachability() {
 
-    QString program = "ph-reach";
-    QStringList arguments;
-
-    // get the filename associated with the current subWindow
-    QString fileName;
-    if(this->getCentraleArea()->currentSubWindow() != 0){ // if a subWindow exists
-        QMdiSubWindow *subWindow = this->getCentraleArea()->currentSubWindow();
-        fileName = ((Area*) subWindow->widget())->path;
-    } else {
-        fileName = "";
-    }
+    if(this->getCentraleArea()->currentSubWindow() == 0)
+        return;
+    Area* area = (Area*) this->getCentraleArea()->currentSubWindow()->widget();
+    PHPtr ph = area->myArea->getPHPtr();
+    if (!ph)
+        return;
 
     //ask the user the state which is tested
     bool ok = false;
-    QString state = QInputDialog::getText(this, "reachability", "Which state do you want to test ?", QLineEdit::Normal, QString(), &ok);
-
-    if (ok && !state.isEmpty()) {
-        // give the arguments
-        QStringList a = this->wordList(state);
-
-        arguments << "--no-debug" << "-i" << fileName;
-
-        for (int j=0; j< a.size(); j++){
-                arguments << a[j];
-            }
+    QString state = QInputDialog::getText(this, "reachability", "Which processes should be active together ? (e.g. a 1 b 0)", QLineEdit::Normal, QString(), &ok);
+    if (!ok || state.isEmpty())
+        return;
+
+    vector<Reachability::Requirement> goal;
+    try {
+        goal = Reachability::parseGoal(*ph, this->wordList(state).join(" ").toStdString());
+    } catch (sort_not_found& x) {
+        QMessageBox::critical(this, "Error !", "Unknown sort: " + QString::fromStdString(*boost::get_error_info<sort_info>(x)));
+        return;
+    } catch (ph_error&) {
+        QMessageBox::critical(this, "Error !", "Each sort must be followed by one of its processes.");
+        return;
+    }
 
-        //call MainWindow::compute
-        this->compute(program, arguments);
+    // the static analysis of a model is kept for the next queries, until the model is edited
+    if (this->causalityModel.lock() != ph) {
+        this->causality = boost::make_shared<LocalCausality>(*ph);
+        this->causalityModel = ph;
     }
+    boost::shared_ptr<LocalCausality> causality = this->causality;
+
+    // the engines copy the model, which may then be edited while the states are explored
+    boost::shared_ptr<Reachability> engine = boost::make_shared<Reachability>(*ph);
+    boost::shared_ptr< vector<int> > witness = boost::make_shared< vector<int> >();
+    AnalysisJob::Task task = [causality, engine, goal, state, witness] (AnalysisJob& job) -> int {
+        job.write("goal: " + state + "\n");
+
+        // the states are only explored when the static analysis is not conclusive
+        LocalCausality::Result c = causality->run(goal);
+        if (c.answer != Reachability::Unknown) {
+            job.write(QString("%1 by local causality, %2 ms\n").arg(QString::fromStdString(Reachability::answerName(c.answer)))
+                        .arg(c.elapsed / 1000.0));
+            *witness = c.witness;
+            return 0;
+        }
+        job.write("local causality not conclusive, exploring the states\n");
+
+        qint64 shown = Trace::now();
+        Reachability::Result r = engine->run(goal, Reachability::Options()
+            , [&job, &shown] (int depth, size_t states) {
+                // at most once a second
+                if (Trace::now() - shown < 1000000)
+                    return;
+                shown = Trace::now();
+                job.write(QString("depth %1, %2 states\n").arg(depth).arg(states));
+            }
+            , [&job] () { return job.isCancelRequested(); });
+        job.write(QString("%1: %2 states, depth %3, %4 ms\n").arg(QString::fromStdString(Reachability::answerName(r.answer)))
+                    .arg(r.states).arg(r.depth).arg(r.elapsed));
+        if (r.answer == Reachability::Unknown && !job.isCancelRequested())
+            job.write("too many states, the exploration stopped\n", true);
+        *witness = r.witness;
+        return r.answer == Reachability::Unknown ? 1 : 0;
+    };
+
+    AnalysisJob* job = new AnalysisJob("reachability", task, area->path);
+    QPointer<Area> tab(area);
+    job->setCallback([tab, ph, witness] (AnalysisJob& job) {
+        if (job.getState() != AnalysisJob::Finished || witness->empty())
+            return;
+        // a path to the goal, a shortest one if the states were explored
+        for (int a : *witness) {
+            Action action = ph->getAction(a);
+            job.write(QString("%1 %2 -> %3 %4 %5\n")
+                        .arg(QString::fromStdString(action.getSource()->getSort()->getName())).arg(action.getSource()->getNumber())
+                        .arg(QString::fromStdString(action.getTarget()->getSort()->getName())).arg(action.getTarget()->getNumber())
+                        .arg(action.getResult()->getNumber()));
+        }
+        // replayed in the scene, unless the tab was closed or its model edited meanwhile
+        if (tab && tab->myArea->getPHPtr() == ph)
+            tab->startReplay(*witness);
+    });
+    this->jobsPanel->addJob(job);
+    this->jobsDock->show();
+    this->jobsDock->raise();
+    job->start();
 }
 
 QStringList MainWindow::wordList(const QString& text){
@@ -1231,7 +1448,7 @@ void MainWindow::runStochasticSimulation() {
             arguments << "--no-debug" << "-i" << fileName << duration << outputdirectory;
 
             //call MainWindow::compute
-            this->compute(program, arguments);
+            this->compute(program, arguments, fileName);
         }
     }
 }
@@ -1266,7 +1483,7 @@ void MainWindow::statistics(){
     arguments << "--no-debug" << "-i" << fileName;
 
     // call MainWindow::compute
-    this->compute(program, arguments);
+    this->compute(program, arguments, fileName);
 }
 
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <QApplication>
 #include <QtGui>
@@ -62,3 +63,56 @@ void TextArea::incrementeNberTextChange(){
 
     this->nberTextChange++;
 }
+
+void TextArea::setDiagnostics(const QList<Diagnostic>& diagnostics){
+
+    this->errors.clear();
+    this->errorMessages.clear();
+
+    QTextCharFormat format;
+    format.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+    format.setUnderlineColor(Qt::red);
+
+    for (const Diagnostic &d : diagnostics) {
+        // errors without a place are shown on the first line
+        QTextBlock block = this->document()->findBlockByNumber(std::max(d.line, 1) - 1);
+        if (!block.isValid())
+            block = this->document()->lastBlock();
+        QTextCursor cursor(block);
+        if (d.column > 0 && d.column <= block.length()) {
+            // the word where the error is, or the next character
+            cursor.setPosition(block.position() + d.column - 1);
+            cursor.movePosition(QTextCursor::EndOfWord, QTextCursor::KeepAnchor);
+            if (!cursor.hasSelection())
+                cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor);
+        } else {
+            cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+        }
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = cursor;
+        selection.format = format;
+        this->errors.append(selection);
+        this->errorMessages.append(d.message);
+    }
+
+    this->setExtraSelections(this->errors);
+}
+
+bool TextArea::event(QEvent* e){
+
+    if (e->type() == QEvent::ToolTip) {
+        QHelpEvent* help = static_cast<QHelpEvent*>(e);
+        int position = this->cursorForPosition(help->pos() - this->viewport()->pos()).position();
+        for (int i = 0; i < this->errors.size(); i++) {
+            const QTextCursor& c = this->errors[i].cursor;
+            if (position >= c.block().position() && position < c.block().position() + c.block().length()) {
+                QToolTip::showText(help->globalPos(), this->errorMessages[i]);
+                return true;
+            }
+        }
+        QToolTip::hideText();
+        e->ignore();
+        return true;
+    }
+    return QTextEdit::event(e);
+}
@@ -4,6 +4,8 @@
 #include <QInputDialog>
 #include <QErrorMessage>
 #include <QMenu>
+#include "PHDiff.h"
+#include "Trace.h"
 
 TreeArea::TreeArea(QWidget *parent): QWidget(parent)
 {
@@ -130,9 +132,9 @@ TreeArea::TreeArea(QWidget *parent): QWidget(parent)
 }
 
 void TreeArea::build(){
+    TRACE_SCOPE("build tree");
     // Get all the sorts of the PH file
-    list<SortPtr> allSorts = this->myPHPtr->getSorts();
-    for(SortPtr &s : allSorts){
+    for(SortPtr &s : this->myPHPtr->getSorts()){
         // Add a new item to the QTReeWidget, named after the sort
         QTreeWidgetItem* a = new QTreeWidgetItem(this->sortsTree);
         a->setText(0, QString::fromStdString(s->getName()));
@@ -141,6 +143,34 @@ void TreeArea::build(){
     }
 }
 
+void TreeArea::patch(const PHDiff& diff){
+    TRACE_SCOPE("patch tree");
+    for(const string &s : diff.removedSorts){
+        QString name = QString::fromStdString(s);
+        for(QTreeWidgetItem* &a : this->sortsTree->findItems(name, Qt::MatchExactly, 0)){
+            this->sorts.removeOne(a);
+            delete a;
+        }
+        for(QTreeWidgetItem* &a : this->groupsTree->findItems(name, Qt::MatchExactly | Qt::MatchRecursive, 0)){
+            if(a->parent()){
+                delete a;
+            }
+        }
+    }
+    // keep the items in the order of the sorts, as built
+    for(const string &s : diff.addedSorts){
+        QString name = QString::fromStdString(s);
+        int index = 0;
+        while(index < this->sortsTree->topLevelItemCount() && this->sortsTree->topLevelItem(index)->text(0).toStdString() < s){
+            index++;
+        }
+        QTreeWidgetItem* a = new QTreeWidgetItem();
+        a->setText(0, name);
+        this->sortsTree->insertTopLevelItem(index, a);
+        this->sorts.push_back(a);
+    }
+}
+
 void TreeArea::searchSort(){
     //Get the text entered in the searchBox
     QString text = this->searchBox->text();
@@ -325,14 +355,12 @@ void TreeArea::hideSort(int clickedTree){
     }
 
     // Hide the QGraphicsItem representing the sort
-    this->myPHPtr->getGraphicsScene()->getGSort(text.toStdString())->GSort::hide();
+    int id = this->myPHPtr->getSort(text.toStdString())->getId();
+    this->myPHPtr->getGraphicsScene()->getGSort(id)->GSort::hide();
 
     // Hide all the actions related to the sort
-    std::vector<GActionPtr> allActions = this->myPHPtr->getGraphicsScene()->getActions();
-    for (GActionPtr &a: allActions){
-        if (a->getAction()->getSource()->getSort()->getName() == text.toStdString() || a->getAction()->getTarget()->getSort()->getName() == text.toStdString() || a->getAction()->getResult()->getSort()->getName() == text.toStdString()){
-            a->getDisplayItem()->hide();
-        }
+    for (int i : this->myPHPtr->getActionsBySort(id)){
+        this->myPHPtr->getGraphicsScene()->getAction(i)->getDisplayItem()->hide();
     }
 }
 
@@ -377,17 +405,16 @@ void TreeArea::showSort(int clickedTree){
     }
 
     // Show the QGraphicsItem representing the sort
-    this->myPHPtr->getGraphicsScene()->getGSort(text.toStdString())->GSort::show();
-
-    std::vector<GActionPtr> allActions = this->myPHPtr->getGraphicsScene()->getActions();
-    for (GActionPtr &a: allActions){
-        if (a->getAction()->getSource()->getSort()->getName() == text.toStdString() || a->getAction()->getTarget()->getSort()->getName() == text.toStdString() || a->getAction()->getResult()->getSort()->getName() == text.toStdString()){
-            if (       (myPHPtr->getGraphicsScene()->getGSort(a->getAction()->getSource()->getSort()->getName())->GSort::isVisible())
-                    && (myPHPtr->getGraphicsScene()->getGSort(a->getAction()->getTarget()->getSort()->getName())->GSort::isVisible())
-                    && (myPHPtr->getGraphicsScene()->getGSort(a->getAction()->getResult()->getSort()->getName())->GSort::isVisible()) )
-            {
-                a->getDisplayItem()->show();
-            }
+    int id = this->myPHPtr->getSort(text.toStdString())->getId();
+    this->myPHPtr->getGraphicsScene()->getGSort(id)->GSort::show();
+
+    for (int i : this->myPHPtr->getActionsBySort(id)){
+        GActionPtr a = this->myPHPtr->getGraphicsScene()->getAction(i);
+        if (       (myPHPtr->getGraphicsScene()->getGSort(a->getAction().getSource()->getSort()->getId())->GSort::isVisible())
+                && (myPHPtr->getGraphicsScene()->getGSort(a->getAction().getTarget()->getSort()->getId())->GSort::isVisible())
+                && (myPHPtr->getGraphicsScene()->getGSort(a->getAction().getResult()->getSort()->getId())->GSort::isVisible()) )
+        {
+            a->getDisplayItem()->show();
         }
     }
 
@@ -487,17 +514,16 @@ void TreeArea::showGroup(){
         for (QTreeWidgetItem* &a: wholeTree){
             if (a->parent() == item){
                 // Show the GraphicsItem
-                this->myPHPtr->getGraphicsScene()->getGSort(a->text(0).toStdString())->GSort::show();
+                int id = this->myPHPtr->getSort(a->text(0).toStdString())->getId();
+                this->myPHPtr->getGraphicsScene()->getGSort(id)->GSort::show();
 
                 // Hide all the actions related to the sort
-                std::vector<GActionPtr> allActions = this->myPHPtr->getGraphicsScene()->getActions();
-                for (GActionPtr &b: allActions){
-                    if (b->getAction()->getSource()->getSort()->getName() == a->text(0).toStdString() || b->getAction()->getTarget()->getSort()->getName() == a->text(0).toStdString() || b->getAction()->getResult()->getSort()->getName() == a->text(0).toStdString()){
-                        if (       (myPHPtr->getGraphicsScene()->getGSort(b->getAction()->getSource()->getSort()->getName())->GSort::isVisible())
-                                && (myPHPtr->getGraphicsScene()->getGSort(b->getAction()->getTarget()->getSort()->getName())->GSort::isVisible())
-                                && (myPHPtr->getGraphicsScene()->getGSort(b->getAction()->getResult()->getSort()->getName())->GSort::isVisible())){
-                            b->getDisplayItem()->show();
-                        }
+                for (int i : this->myPHPtr->getActionsBySort(id)){
+                    GActionPtr b = this->myPHPtr->getGraphicsScene()->getAction(i);
+                    if (       (myPHPtr->getGraphicsScene()->getGSort(b->getAction().getSource()->getSort()->getId())->GSort::isVisible())
+                            && (myPHPtr->getGraphicsScene()->getGSort(b->getAction().getTarget()->getSort()->getId())->GSort::isVisible())
+                            && (myPHPtr->getGraphicsScene()->getGSort(b->getAction().getResult()->getSort()->getId())->GSort::isVisible())){
+                        b->getDisplayItem()->show();
                     }
                 }
 
@@ -534,14 +560,12 @@ void TreeArea::hideGroup(){
         for (QTreeWidgetItem* &a: wholeTree){
                 if (a->parent() == item){
                     // Hide the GraphicsItem
-                    this->myPHPtr->getGraphicsScene()->getGSort(a->text(0).toStdString())->GSort::hide();
+                    int id = this->myPHPtr->getSort(a->text(0).toStdString())->getId();
+                    this->myPHPtr->getGraphicsScene()->getGSort(id)->GSort::hide();
 
                     // Hide all the actions related to the sort
-                    std::vector<GActionPtr> allActions = this->myPHPtr->getGraphicsScene()->getActions();
-                    for (GActionPtr &b: allActions){
-                        if (b->getAction()->getSource()->getSort()->getName() == a->text(0).toStdString() || b->getAction()->getTarget()->getSort()->getName() == a->text(0).toStdString() || b->getAction()->getResult()->getSort()->getName() == a->text(0).toStdString()){
-                            b->getDisplayItem()->hide();
-                        }
+                    for (int i : this->myPHPtr->getActionsBySort(id)){
+                        this->myPHPtr->getGraphicsScene()->getAction(i)->getDisplayItem()->hide();
                     }
 
                     // Set the font to Italic